@@ -0,0 +1,218 @@
+//////////////////////////////////////////////////////////////////////
+// \file    AssnCache.h
+// \brief   Event-scoped index of art::Assns for repeated per-slice lookups
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_ASSNCACHE_H
+#define CAF_ASSNCACHE_H
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Persistency/Common/Assns.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib/maybe_ref.h"
+
+#include "sbncode/CAFMaker/KeyRangeIndex.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace caf
+{
+  /// \brief Flat index of one art::Assns<L, R, D> product
+  ///
+  /// The association pairs are sorted once by the (ProductID, key) of their
+  /// left-hand Ptr, so that all the right-hand objects of a given left object
+  /// are a contiguous range found by binary search. The sort is stable, so
+  /// the objects come out in the same order FindManyP would return them.
+  template <class L, class R, class D = void>
+  class AssnIndex
+  {
+  public:
+    /// \param assns The association product, or nullptr if it was not found
+    explicit AssnIndex(const art::Assns<L, R, D>* assns);
+
+    bool isValid() const { return fAssns != nullptr; }
+
+    /// Append the objects associated to \a left (and their data, if any)
+    void Find(const art::Ptr<L>& left,
+              std::vector<art::Ptr<R>>& rights,
+              std::vector<const D*>* data = nullptr) const;
+
+  private:
+    const art::Assns<L, R, D>* fAssns;
+    KeyRangeIndex<art::ProductID> fIndex;
+  };
+
+  /// \brief Per-event cache of AssnIndex objects
+  ///
+  /// Each (association type, input tag) combination is read from the event
+  /// and indexed on first use, and shared by every subsequent lookup until
+  /// Clear() is called at the start of the next event. Get() may be called
+  /// concurrently; Clear() may not.
+  class AssnCache
+  {
+  public:
+    template <class L, class R, class D = void>
+    const AssnIndex<L, R, D>& Get(const art::Event& evt, const art::InputTag& tag);
+
+    void Clear() { fIndices.clear(); }
+
+  private:
+    struct IndexBase {
+      virtual ~IndexBase() = default;
+    };
+
+    template <class L, class R, class D>
+    struct IndexHolder: public IndexBase {
+      explicit IndexHolder(const art::Assns<L, R, D>* assns): index(assns) {}
+      AssnIndex<L, R, D> index;
+    };
+
+    std::map<std::pair<std::type_index, std::string>, std::unique_ptr<IndexBase>> fIndices;
+    std::mutex fMutex;
+  };
+
+  /// Drop-in replacement for art::FindManyP, served from an AssnCache
+  template <class R, class D = void>
+  class CachedFindManyP
+  {
+  public:
+    CachedFindManyP() = default;
+
+    template <class L>
+    CachedFindManyP(const std::vector<art::Ptr<L>>& from, const AssnIndex<L, R, D>& index);
+
+    bool isValid() const { return fValid; }
+    std::size_t size() const { return fResults.size(); }
+
+    const std::vector<art::Ptr<R>>& at(std::size_t i) const { return fResults.at(i); }
+    const std::vector<const D*>& data(std::size_t i) const { return fData.at(i); }
+
+  private:
+    bool fValid = false;
+    std::vector<std::vector<art::Ptr<R>>> fResults;
+    std::vector<std::vector<const D*>> fData;
+  };
+
+  /// Drop-in replacement for art::FindOneP, served from an AssnCache
+  template <class R, class D = void>
+  class CachedFindOneP
+  {
+  public:
+    CachedFindOneP() = default;
+
+    template <class L>
+    CachedFindOneP(const std::vector<art::Ptr<L>>& from, const AssnIndex<L, R, D>& index);
+
+    bool isValid() const { return fMany.isValid(); }
+    std::size_t size() const { return fMany.size(); }
+
+    /// The first associated object, or a null Ptr if there is none
+    art::Ptr<R> at(std::size_t i) const
+    {
+      const std::vector<art::Ptr<R>>& rs = fMany.at(i);
+      return rs.empty() ? art::Ptr<R>() : rs.front();
+    }
+
+    cet::maybe_ref<const D> data(std::size_t i) const
+    {
+      const std::vector<const D*>& ds = fMany.data(i);
+      return ds.empty() ? cet::maybe_ref<const D>() : cet::maybe_ref<const D>(*ds.front());
+    }
+
+  private:
+    CachedFindManyP<R, D> fMany;
+  };
+
+  //......................................................................
+  template <class L, class R, class D>
+  AssnIndex<L, R, D>::AssnIndex(const art::Assns<L, R, D>* assns)
+    : fAssns(assns)
+  {
+    if (!fAssns) return;
+
+    fIndex.Reserve(fAssns->size());
+    for (std::size_t i = 0; i < fAssns->size(); i++) {
+      const art::Ptr<L>& left = (*fAssns)[i].first;
+      fIndex.Add(left.id(), left.key(), i);
+    }
+    fIndex.Sort();
+  }
+
+  //......................................................................
+  template <class L, class R, class D>
+  void AssnIndex<L, R, D>::Find(const art::Ptr<L>& left,
+                                std::vector<art::Ptr<R>>& rights,
+                                std::vector<const D*>* data) const
+  {
+    if (!fAssns || left.isNull()) return;
+
+    const auto range = fIndex.Range(left.id(), left.key());
+    for (auto it = range.first; it != range.second; ++it) {
+      rights.push_back((*fAssns)[it->index].second);
+      if constexpr (!std::is_void_v<D>) {
+        if (data) data->push_back(&fAssns->data(it->index));
+      }
+    }
+  }
+
+  //......................................................................
+  template <class L, class R, class D>
+  const AssnIndex<L, R, D>& AssnCache::Get(const art::Event& evt, const art::InputTag& tag)
+  {
+    const std::pair<std::type_index, std::string> key(typeid(art::Assns<L, R, D>), tag.encode());
+
+    // std::map nodes are stable, so the returned reference stays valid
+    // after the lock is released
+    std::lock_guard<std::mutex> lock(fMutex);
+    auto it = fIndices.find(key);
+    if (it == fIndices.end()) {
+      const art::Assns<L, R, D>* assns = nullptr;
+      if (!tag.label().empty()) {
+        art::Handle<art::Assns<L, R, D>> handle;
+        evt.getByLabel(tag, handle);
+        if (handle.isValid()) assns = handle.product();
+      }
+      it = fIndices.emplace(key, std::make_unique<IndexHolder<L, R, D>>(assns)).first;
+    }
+
+    return static_cast<const IndexHolder<L, R, D>&>(*it->second).index;
+  }
+
+  //......................................................................
+  template <class R, class D>
+  template <class L>
+  CachedFindManyP<R, D>::CachedFindManyP(const std::vector<art::Ptr<L>>& from,
+                                         const AssnIndex<L, R, D>& index)
+    : fValid(index.isValid())
+    , fResults(from.size())
+    , fData(from.size())
+  {
+    if (!fValid) return;
+
+    for (std::size_t i = 0; i < from.size(); i++) {
+      index.Find(from[i], fResults[i], &fData[i]);
+    }
+  }
+
+  //......................................................................
+  template <class R, class D>
+  template <class L>
+  CachedFindOneP<R, D>::CachedFindOneP(const std::vector<art::Ptr<L>>& from,
+                                       const AssnIndex<L, R, D>& index)
+    : fMany(from, index)
+  {}
+
+} // end namespace caf
+
+#endif
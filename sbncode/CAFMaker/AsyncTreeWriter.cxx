@@ -0,0 +1,106 @@
+#include "sbncode/CAFMaker/AsyncTreeWriter.h"
+
+#include "cetlib_except/exception.h"
+
+namespace caf
+{
+  //......................................................................
+  AsyncTreeWriter::AsyncTreeWriter(unsigned int queueSize)
+    : fQueueSize(queueSize)
+  {
+    if (IsAsync()) fThread = std::thread(&AsyncTreeWriter::Run, this);
+  }
+
+  //......................................................................
+  AsyncTreeWriter::~AsyncTreeWriter()
+  {
+    if (!IsAsync()) return;
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fJobReady.notify_one();
+    // Outstanding jobs are still run before the thread exits
+    fThread.join();
+  }
+
+  //......................................................................
+  void AsyncTreeWriter::Submit(std::function<void()> job)
+  {
+    if (!IsAsync()) {
+      job();
+      return;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fJobDone.wait(lock, [this] { return fJobs.size() < fQueueSize || fError; });
+      RethrowIfFailed();
+      fJobs.push_back(std::move(job));
+    }
+    fJobReady.notify_one();
+  }
+
+  //......................................................................
+  void AsyncTreeWriter::Flush()
+  {
+    if (!IsAsync()) return;
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fJobDone.wait(lock, [this] { return (fJobs.empty() && !fBusy) || fError; });
+    RethrowIfFailed();
+  }
+
+  //......................................................................
+  void AsyncTreeWriter::Run()
+  {
+    std::unique_lock<std::mutex> lock(fMutex);
+    while (true) {
+      fJobReady.wait(lock, [this] { return !fJobs.empty() || fStop; });
+      if (fJobs.empty()) return; // stopping, and nothing left to do
+
+      std::function<void()> job = std::move(fJobs.front());
+      fJobs.pop_front();
+      fBusy = true;
+
+      lock.unlock();
+      try {
+        job();
+      }
+      catch (...) {
+        lock.lock();
+        if (!fError) fError = std::current_exception();
+        lock.unlock();
+      }
+      lock.lock();
+
+      fBusy = false;
+      fJobDone.notify_all();
+    }
+  }
+
+  //......................................................................
+  void AsyncTreeWriter::RethrowIfFailed()
+  {
+    if (!fError) return;
+
+    std::exception_ptr error = fError;
+    fError = nullptr;
+
+    // As a cet::exception, so that art reports it like any other module error
+    try {
+      std::rethrow_exception(error);
+    }
+    catch (const cet::exception& e) {
+      throw cet::exception("AsyncTreeWriter", "Writing the CAF output failed", e);
+    }
+    catch (const std::exception& e) {
+      throw cet::exception("AsyncTreeWriter") << "Writing the CAF output failed: " << e.what() << "\n";
+    }
+    catch (...) {
+      throw cet::exception("AsyncTreeWriter") << "Writing the CAF output failed with an unknown exception\n";
+    }
+  }
+
+} // end namespace caf
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////
+// \file    AsyncTreeWriter.h
+// \brief   Runs CAF output jobs (flattening, TTree::Fill) off the event loop
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_ASYNCTREEWRITER_H
+#define CAF_ASYNCTREEWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace caf
+{
+  /// \brief Single writer thread fed through a bounded queue
+  ///
+  /// All the jobs touching the output files are run on the same thread, in
+  /// the order they were submitted, so ROOT only ever sees one thread writing
+  /// to them. With a queue size of zero no thread is started and Submit()
+  /// runs the job immediately, which is exactly the synchronous behaviour.
+  ///
+  /// Anything else that touches the output files (writing other trees,
+  /// closing them) must call Flush() first.
+  class AsyncTreeWriter
+  {
+  public:
+    explicit AsyncTreeWriter(unsigned int queueSize = 0);
+    ~AsyncTreeWriter();
+
+    AsyncTreeWriter(const AsyncTreeWriter&) = delete;
+    AsyncTreeWriter& operator=(const AsyncTreeWriter&) = delete;
+
+    bool IsAsync() const { return fQueueSize > 0; }
+
+    /// Queue \a job, blocking while the queue is full
+    void Submit(std::function<void()> job);
+
+    /// Wait until every submitted job has run. Rethrows the first exception
+    /// thrown by a job, if any, as a cet::exception (so does Submit())
+    void Flush();
+
+  private:
+    void Run();
+    void RethrowIfFailed();
+
+    unsigned int fQueueSize;
+
+    std::deque<std::function<void()>> fJobs;
+    bool fBusy = false;
+    bool fStop = false;
+    std::exception_ptr fError;
+
+    std::mutex fMutex;
+    std::condition_variable fJobReady;   ///< Signals the writer thread
+    std::condition_variable fJobDone;    ///< Signals Submit() and Flush()
+
+    std::thread fThread;
+  };
+
+} // end namespace caf
+
+#endif
@@ -49,6 +49,13 @@ namespace caf
 	Comment("Factor by which to prescale unblind events"), 10
     };
 
+    Atom<bool> BlindStreamsInPlace { Name("BlindStreamsInPlace"),
+      Comment("Write the blind and prescale streams from the unblinded record, by overriding its"
+              " header and blinding it once the unblinded trees are filled, instead of from a deep"
+              " copy of it. Saves one record copy per event; the output is the same."),
+      false
+    };
+
     Atom<int> POTBlindSeed { Name("POTBlindNum"),
 	Comment("Integer used to derive POT scaling factor for blind events"), 655277
     };
@@ -91,6 +98,43 @@ namespace caf
       false
     };
 
+    Atom<bool> ParallelSliceFill {
+      Name("ParallelSliceFill"),
+      Comment("Fill the reco information of the slices concurrently as TBB tasks."
+              " Truth matching still runs serially, and the output is identical to the serial mode."),
+      false
+    };
+
+    Atom<bool> EnableMonitoring {
+      Name("EnableMonitoring"),
+      Comment("Time the stages of the CAF filling. The per-event times go to a 'timing' tree"
+              " through the TFileService, and the means are printed at the end of the job."),
+      false
+    };
+
+    Atom<unsigned int> WriterQueueSize {
+      Name("WriterQueueSize"),
+      Comment("Number of events that may be queued for a separate thread writing the output trees"
+              " (flattening, compression and Fill). 0 writes them synchronously in produce()."),
+      0
+    };
+
+    Sequence<std::string> SkimIncludeBranches {
+      Name("SkimIncludeBranches"),
+      Comment("Write a skim CAF keeping only these StandardRecord sub-records (e.g. 'slc', 'slc.reco.hit'),"
+              " their parents and their children. Sub-records CAFMaker cannot drop, like the header,"
+              " are always kept. Empty keeps everything. Allowed: the same names as SkimExcludeBranches"),
+      std::vector<std::string>()
+    };
+
+    Sequence<std::string> SkimExcludeBranches {
+      Name("SkimExcludeBranches"),
+      Comment("StandardRecord sub-records (and their children) that are not filled. Allowed: mc, fake_reco,"
+              " true_particles, crt_hits, crt_tracks, crt_spacepoints, sbnd_crt_tracks, crtpmt_matches,"
+              " opflashes, reco.hit, reco.stub, slc, slc.reco.hit, slc.reco.stub, slc.reco.pfp.trk.calo"),
+      std::vector<std::string>()
+    };
+
     fhicl::OptionalSequence<std::string> PandoraTagSuffixes {
       Name("PandoraTagSuffixes"),
       Comment("List of suffixes to add to TPC reco tag names (e.g. cryo0 cryo1)")
@@ -400,6 +444,22 @@ namespace caf
       Comment("Labels for EventWeightMap objects for mc.nu.wgt")
     };
 
+    Atom<bool> DropAllOnesSystWeights {
+      Name("DropAllOnesSystWeights"),
+      Comment("Store a single weight of 1 in mc.nu.wgt.univ when all its weights are 1."
+              " Readers must then take a single weight as that of all the nuniv (in SRGlobal)"
+              " universes: leave off until they do"),
+      false
+    };
+
+    Atom<bool> QuantizeSystWeights {
+      Name("QuantizeSystWeights"),
+      Comment("Round mc.nu.wgt.univ to half precision values, which compress better."
+              " Relative error below 2^-11 (4.9e-4) for weights from 6.1e-5 to 65504,"
+              " absolute error below 3e-8 for smaller ones, larger ones are unchanged"),
+      false
+    };
+
     Atom<bool> FillHitsAllSlices {
       Name("FillHitsAllSlices"),
       Comment("Fill per-hit information in all reconstructed slices."),
@@ -30,6 +30,7 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -38,9 +39,13 @@
 #ifdef DARWINBUILD
 #include <libgen.h>
 #endif
+#include <sys/resource.h>
 
 #include "ifdh_art/IFDHService/IFDH_service.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 // ROOT includes
 #include "TFile.h"
 #include "TH1D.h"
@@ -48,6 +53,7 @@
 #include "TMath.h"
 #include "TTimeStamp.h"
 #include "TObjString.h"
+#include "TROOT.h"
 
 // CLHEP libraries
 #include "CLHEP/Random/RandEngine.h" // CLHEP::HepRandomEngine
@@ -79,6 +85,7 @@
 #include "canvas/Persistency/Common/Ptr.h"
 #include "canvas/Persistency/Common/PtrVector.h"
 
+#include "cetlib/cpu_timer.h"
 #include "cetlib_except/exception.h"
 #include "cetlib_except/demangle.h"
 
@@ -134,6 +141,9 @@
 
 // // CAFMaker
 #include "sbncode/CAFMaker/AssociationUtil.h"
+#include "sbncode/CAFMaker/AssnCache.h"
+#include "sbncode/CAFMaker/AsyncTreeWriter.h"
+#include "sbncode/CAFMaker/SkimMask.h"
 // #include "sbncode/CAFMaker/Blinding.h"
 
 // Metadata
@@ -164,6 +174,30 @@ double spillInfoToTimestamp(SpillInfo const& info) {
          static_cast<double>(info.spill_time_ns)*1.0e-9;
 }
 
+/// Adds the real time between its construction and Stop() (or the end of
+/// its scope) to a stage time. Does nothing if not enabled.
+class StageTimer {
+ public:
+  StageTimer(bool enabled, float& stageTime): fEnabled(enabled), fStageTime(stageTime)
+  {
+    if (fEnabled) fClock.start();
+  }
+  ~StageTimer() { Stop(); }
+
+  void Stop()
+  {
+    if (!fEnabled) return;
+    fClock.stop();
+    fStageTime += fClock.accumulated_real_time();
+    fEnabled = false;
+  }
+
+ private:
+  bool fEnabled;
+  float& fStageTime;
+  cet::cpu_timer fClock;
+};
+
 /// Module to create Common Analysis Files from ART files
 class CAFMaker : public art::EDProducer {
  public:
@@ -173,7 +207,7 @@ class CAFMaker : public art::EDProducer {
   explicit CAFMaker(const Parameters& params);
   virtual ~CAFMaker();
 
-  void produce(art::Event& evt) noexcept;
+  void produce(art::Event& evt);
 
   void respondToOpenInputFile(const art::FileBlock& fb);
 
@@ -245,6 +279,8 @@ class CAFMaker : public art::EDProducer {
   TTree                   * fFlatGenieTree = 0;
   bool fSaveGENIEEventRecord;
   unsigned int fGenieEventCounter;
+  unsigned int fGenieTreeEntry;            ///< GENIEEntry branch, set by fWriter
+  std::uint32_t fGenieTreeSourceFileHash;  ///< SourceFileHash branch, set by fWriter
 
   flat::Flat<caf::StandardRecord>* fFlatRecord = 0;
   flat::Flat<caf::StandardRecord>* fFlatRecordb = 0;
@@ -267,6 +303,49 @@ class CAFMaker : public art::EDProducer {
   /// Map from parameter labels to previously seen parameter set configuration
   std::map<std::string, std::vector<sbn::evwgh::EventWeightParameterSet>> fPrevWeightPSet;
 
+  /// Associations indexed once per event, shared by all the slices
+  AssnCache fAssnCache;
+
+  /// Runs all the output tree fills, optionally on its own thread
+  std::unique_ptr<AsyncTreeWriter> fWriter;
+
+  /// Sub-records left unfilled in a skim CAF
+  SkimMask fSkim;
+
+  /// Time spent in the stages of produce(), in seconds
+  struct StageTiming {
+    float truthParticles = 0.f; ///< FillTrueG4Particle for all MCParticles
+    float trueNeutrinos = 0.f;  ///< FillTrueNeutrino
+    float crt = 0.f;            ///< CRT hits, tracks, space points and CRT-PMT matches
+    float opflash = 0.f;        ///< OpFlashes
+    float sliceReco = 0.f;      ///< Reco fill of all slices, tracks and showers included
+    float pfpTrack = 0.f;       ///< Track fill, summed over PFPs (and threads)
+    float pfpShower = 0.f;      ///< Shower fill, summed over PFPs (and threads)
+    float truthMatching = 0.f;  ///< Slice, stub, track and shower truth matching
+    float treeWrite = 0.f;      ///< Output tree fills, as seen from produce()
+    float total = 0.f;          ///< All of produce()
+  };
+
+  /**
+   *   Monitoring tree, see EnableMonitoring
+   */
+  bool fEnableMonitoring;
+  TTree* fTimingTree = 0;
+  /// One entry of fTimingTree
+  struct TimingEntry {
+    int run;
+    int event;
+    float maxRSS;             ///< Peak resident memory so far [MB]
+    StageTiming time;
+  };
+  TimingEntry fTimingEntry;   ///< fTimingTree branches, set by fWriter
+  float fTimingMaxRSS;        ///< Peak resident memory so far [MB]
+  StageTiming fTiming;        ///< This event
+  StageTiming fTimingSum;     ///< Summed over the job, for the end-of-job summary
+  unsigned int fTimingEvents = 0;
+
+  void InitializeMonitoring();
+
   std::string DeriveFilename(const std::string& inname,
                              const std::string& ext) const;
 
@@ -289,26 +368,30 @@ class CAFMaker : public art::EDProducer {
   void FixCRTReferenceTimes(StandardRecord &rec, double CRTT0_reference_time, double CRTT1_reference_time);
 
   /// Equivalent of FindManyP except a return that is !isValid() prints a
-  /// messsage and aborts if StrictMode is true.
+  /// messsage and aborts if StrictMode is true. The association is looked
+  /// up through the event-level fAssnCache.
   template <class T, class U>
-  art::FindManyP<T> FindManyPStrict(const U& from, const art::Event& evt,
-                                    const art::InputTag& label) const;
+  CachedFindManyP<T> FindManyPStrict(const std::vector<art::Ptr<U>>& from,
+                                     const art::Event& evt,
+                                     const art::InputTag& label);
 
   template <class T, class D, class U>
-  art::FindManyP<T, D> FindManyPDStrict(const U& from,
-                                        const art::Event& evt,
-                                        const art::InputTag& tag) const;
+  CachedFindManyP<T, D> FindManyPDStrict(const std::vector<art::Ptr<U>>& from,
+                                         const art::Event& evt,
+                                         const art::InputTag& tag);
 
   /// Equivalent of FindOneP except a return that is !isValid() prints a
-  /// messsage and aborts if StrictMode is true.
+  /// messsage and aborts if StrictMode is true. The association is looked
+  /// up through the event-level fAssnCache.
   template <class T, class U>
-  art::FindOneP<T> FindOnePStrict(const U& from, const art::Event& evt,
-				  const art::InputTag& label) const;
+  CachedFindOneP<T> FindOnePStrict(const std::vector<art::Ptr<U>>& from,
+                                   const art::Event& evt,
+                                   const art::InputTag& label);
 
   template <class T, class D, class U>
-  art::FindOneP<T, D> FindOnePDStrict(const U& from,
-                                      const art::Event& evt,
-                                      const art::InputTag& tag) const;
+  CachedFindOneP<T, D> FindOnePDStrict(const std::vector<art::Ptr<U>>& from,
+                                       const art::Event& evt,
+                                       const art::InputTag& tag);
 
   /// \brief Retrieve an object from an association, with error handling
   ///
@@ -322,7 +405,7 @@ class CAFMaker : public art::EDProducer {
   /// \param[out] ret The product retrieved
   /// \return          Whether \a ret was filled
   template <class T>
-  bool GetAssociatedProduct(const art::FindManyP<T>& fm, int idx, T& ret) const;
+  bool GetAssociatedProduct(const CachedFindManyP<T>& fm, int idx, T& ret) const;
 
   /// Equivalent of evt.getByLabel(label, handle) except failedToGet
   /// prints a message and aborts if StrictMode is true.
@@ -390,6 +473,35 @@ class CAFMaker : public art::EDProducer {
 
   fSaveGENIEEventRecord = fParams.SaveGENIEEventRecord();
 
+  fEnableMonitoring = fParams.EnableMonitoring();
+
+  if (fParams.WriterQueueSize() > 0) ROOT::EnableThreadSafety();
+  fWriter = std::make_unique<AsyncTreeWriter>(fParams.WriterQueueSize());
+
+  const std::vector<std::string> skimInclude = fParams.SkimIncludeBranches();
+  const std::vector<std::string> skimExclude = fParams.SkimExcludeBranches();
+  for (const bool include: {true, false}) {
+    for (const std::string &name: include ? skimInclude : skimExclude) {
+      if (!SkimMask::IsKnown(name)) {
+        std::cout << "CAFMaker: " << (include ? "SkimIncludeBranches" : "SkimExcludeBranches")
+                  << ": '" << name << "' can not be " << (include ? "selected" : "dropped") << std::endl;
+        abort();
+      }
+    }
+  }
+  fSkim = SkimMask(skimInclude, skimExclude);
+  if (fSkim.IsSkim()) {
+    mf::LogInfo log("CAFMaker");
+    log << "Writing a skim CAF";
+    if (!skimInclude.empty()) {
+      log << " of:";
+      for (const std::string &name: skimInclude) log << " " << name;
+      log << ",";
+    }
+    log << " without:";
+    for (const std::string &name: fSkim.Dropped()) log << " " << name;
+  }
+
 }
 
 //......................................................................
@@ -552,6 +664,8 @@ void CAFMaker::InitVolumes() {
 //......................................................................
 CAFMaker::~CAFMaker()
 {
+  // Finish any pending writes before the trees go away
+  fWriter.reset();
 
   delete fGenieEvtRec;
   delete fGenieTree;
@@ -674,6 +788,27 @@ void CAFMaker::respondToOpenInputFile(const art::FileBlock& fb) {
 //......................................................................
 void CAFMaker::beginJob()
 {
+  if (fEnableMonitoring) InitializeMonitoring();
+}
+
+//......................................................................
+void CAFMaker::InitializeMonitoring()
+{
+  art::ServiceHandle<art::TFileService> tfs;
+  fTimingTree = tfs->make<TTree>("timing", "CAFMaker stage timing");
+  fTimingTree->Branch("run", &fTimingEntry.run, "run/I");
+  fTimingTree->Branch("event", &fTimingEntry.event, "event/I");
+  fTimingTree->Branch("maxRSS", &fTimingEntry.maxRSS, "maxRSS/F");
+  fTimingTree->Branch("truthParticlesTime", &fTimingEntry.time.truthParticles, "time/F");
+  fTimingTree->Branch("trueNeutrinosTime", &fTimingEntry.time.trueNeutrinos, "time/F");
+  fTimingTree->Branch("crtTime", &fTimingEntry.time.crt, "time/F");
+  fTimingTree->Branch("opflashTime", &fTimingEntry.time.opflash, "time/F");
+  fTimingTree->Branch("sliceRecoTime", &fTimingEntry.time.sliceReco, "time/F");
+  fTimingTree->Branch("pfpTrackTime", &fTimingEntry.time.pfpTrack, "time/F");
+  fTimingTree->Branch("pfpShowerTime", &fTimingEntry.time.pfpShower, "time/F");
+  fTimingTree->Branch("truthMatchingTime", &fTimingEntry.time.truthMatching, "time/F");
+  fTimingTree->Branch("treeWriteTime", &fTimingEntry.time.treeWrite, "time/F");
+  fTimingTree->Branch("totalTime", &fTimingEntry.time.total, "time/F");
 }
 
 //......................................................................
@@ -783,6 +918,7 @@ void CAFMaker::beginRun(art::Run& run) {
     } // end for pset
   } // end for label
 
+  fWriter->Flush();
   if(fFile) AddGlobalTreeToFile(fFile, global);
   if(fParams.CreateBlindedCAF() && fFileb) AddGlobalTreeToFile(fFileb, global);
   if(fParams.CreateBlindedCAF() && fFilep) AddGlobalTreeToFile(fFilep, global);
@@ -1008,8 +1144,8 @@ void CAFMaker::InitializeOutfiles()
     if (fSaveGENIEEventRecord) {
       fGenieTree = new TTree( "GenieEvtRecTree", "GenieEvtRecTree" );
       fGenieTree->Branch("GenieEvtRec", &fGenieEvtRec);
-      fGenieTree->Branch("GENIEEntry", &fGenieEventCounter, "GENIEEntry/i");
-      fGenieTree->Branch("SourceFileHash", &fSourceFileHash, "SourceFileHash/i");
+      fGenieTree->Branch("GENIEEntry", &fGenieTreeEntry, "GENIEEntry/i");
+      fGenieTree->Branch("SourceFileHash", &fGenieTreeSourceFileHash, "SourceFileHash/i");
     }
 
   }     
@@ -1051,8 +1187,8 @@ void CAFMaker::InitializeOutfiles()
     if (fSaveGENIEEventRecord){
       fFlatGenieTree = new TTree( "GenieEvtRecTree", "GenieEvtRecTree" );
       fFlatGenieTree->Branch("GenieEvtRec", &fFlatGenieEvtRec);
-      fFlatGenieTree->Branch("GENIEEntry", &fGenieEventCounter, "GENIE/i");
-      fFlatGenieTree->Branch("SourceFileHash", &fSourceFileHash, "SourceFileHash/i");
+      fFlatGenieTree->Branch("GENIEEntry", &fGenieTreeEntry, "GENIE/i");
+      fFlatGenieTree->Branch("SourceFileHash", &fGenieTreeSourceFileHash, "SourceFileHash/i");
     }
 
   }
@@ -1077,10 +1213,10 @@ void CAFMaker::InitializeOutfiles()
 
 //......................................................................
 template <class T, class U>
-art::FindManyP<T> CAFMaker::FindManyPStrict(const U& from,
-                                            const art::Event& evt,
-                                            const art::InputTag& tag) const {
-  art::FindManyP<T> ret(from, evt, tag);
+CachedFindManyP<T> CAFMaker::FindManyPStrict(const std::vector<art::Ptr<U>>& from,
+                                             const art::Event& evt,
+                                             const art::InputTag& tag) {
+  CachedFindManyP<T> ret(from, fAssnCache.Get<U, T>(evt, tag));
 
   if (!tag.label().empty() && !ret.isValid() && fParams.StrictMode()) {
     std::cout << "CAFMaker: No Assn from '"
@@ -1096,10 +1232,10 @@ art::FindManyP<T> CAFMaker::FindManyPStrict(const U& from,
 
 //......................................................................
 template <class T, class D, class U>
-art::FindManyP<T, D> CAFMaker::FindManyPDStrict(const U& from,
-                                            const art::Event& evt,
-                                            const art::InputTag& tag) const {
-  art::FindManyP<T, D> ret(from, evt, tag);
+CachedFindManyP<T, D> CAFMaker::FindManyPDStrict(const std::vector<art::Ptr<U>>& from,
+                                                 const art::Event& evt,
+                                                 const art::InputTag& tag) {
+  CachedFindManyP<T, D> ret(from, fAssnCache.Get<U, T, D>(evt, tag));
 
   if (!tag.label().empty() && !ret.isValid() && fParams.StrictMode()) {
     std::cout << "CAFMaker: No Assn from '"
@@ -1115,10 +1251,10 @@ art::FindManyP<T, D> CAFMaker::FindManyPDStrict(const U& from,
 
 //......................................................................
 template <class T, class U>
-art::FindOneP<T> CAFMaker::FindOnePStrict(const U& from,
-					  const art::Event& evt,
-					  const art::InputTag& tag) const {
-  art::FindOneP<T> ret(from, evt, tag);
+CachedFindOneP<T> CAFMaker::FindOnePStrict(const std::vector<art::Ptr<U>>& from,
+                                           const art::Event& evt,
+                                           const art::InputTag& tag) {
+  CachedFindOneP<T> ret(from, fAssnCache.Get<U, T>(evt, tag));
 
   if (!tag.label().empty() && !ret.isValid() && fParams.StrictMode()) {
     std::cout << "CAFMaker: No Assn from '"
@@ -1134,10 +1270,10 @@ art::FindOneP<T> CAFMaker::FindOnePStrict(const U& from,
 
 //......................................................................
 template <class T, class D, class U>
-art::FindOneP<T, D> CAFMaker::FindOnePDStrict(const U& from,
-                                              const art::Event& evt,
-                                              const art::InputTag& tag) const {
-  art::FindOneP<T, D> ret(from, evt, tag);
+CachedFindOneP<T, D> CAFMaker::FindOnePDStrict(const std::vector<art::Ptr<U>>& from,
+                                               const art::Event& evt,
+                                               const art::InputTag& tag) {
+  CachedFindOneP<T, D> ret(from, fAssnCache.Get<U, T, D>(evt, tag));
 
   if (!tag.label().empty() && !ret.isValid() && fParams.StrictMode()) {
     std::cout << "CAFMaker: No Assn from '"
@@ -1153,11 +1289,11 @@ art::FindOneP<T, D> CAFMaker::FindOnePDStrict(const U& from,
 
 //......................................................................
 template <class T>
-bool CAFMaker::GetAssociatedProduct(const art::FindManyP<T>& fm, int idx,
+bool CAFMaker::GetAssociatedProduct(const CachedFindManyP<T>& fm, int idx,
                                     T& ret) const {
   if (!fm.isValid()) return false;
 
-  const std::vector<art::Ptr<T>> prods = fm.at(idx);
+  const std::vector<art::Ptr<T>>& prods = fm.at(idx);
 
   if (prods.empty()) return false;
 
@@ -1210,10 +1346,16 @@ bool CAFMaker::GetPsetParameter(const fhicl::ParameterSet& pset,
 }
 
 //......................................................................
-void CAFMaker::produce(art::Event& evt) noexcept {
+void CAFMaker::produce(art::Event& evt) {
+
+  fTiming = StageTiming();
+  StageTimer totalTimer(fEnableMonitoring, fTiming.total);
 
   bool const firstInFile = (fIndexInFile++ == 0);
 
+  // Associations are indexed lazily on first use in this event
+  fAssnCache.Clear();
+
   // is this event real data?
   bool isRealData = evt.isRealData();
 
@@ -1235,7 +1377,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   }
 
   // And associated GTruth objects
-  art::FindManyP<simb::GTruth> fmp_gtruth = FindManyPStrict<simb::GTruth>(mctruths, evt, fParams.GenLabel());
+  CachedFindManyP<simb::GTruth> fmp_gtruth = FindManyPStrict<simb::GTruth>(mctruths, evt, fParams.GenLabel());
 
   art::Handle<std::vector<simb::MCTruth>> cosmic_mctruth_handle;
   evt.getByLabel(fParams.CosmicGenLabel(), cosmic_mctruth_handle);
@@ -1325,16 +1467,20 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   }
 
   // Prep truth-to-reco-matching info
-  std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> id_to_ide_map;
-  std::map<int, std::vector<art::Ptr<recob::Hit>>> id_to_truehit_map;
+  caf::IDEMap id_to_ide_map;
+  caf::TrueHitMap id_to_truehit_map;
   std::map<int, caf::HitsEnergy> id_to_hit_energy_map;
+  caf::HitTruthTable hit_truth;
 
   if ( !isRealData ) {
     art::ServiceHandle<cheat::BackTrackerService> bt_serv;
 
     id_to_ide_map = PrepSimChannels(simchannels, wireReadout);
-    id_to_truehit_map = PrepTrueHits(hits, clock_data, *bt_serv);
-    id_to_hit_energy_map = SetupIDHitEnergyMap(hits, clock_data, *bt_serv);
+    // Backtrack every hit once; all the slice/track/shower/stub matching
+    // below is served from this table
+    hit_truth = caf::HitTruthTable(hits, clock_data, *bt_serv);
+    id_to_truehit_map = hit_truth.TrueHits();
+    id_to_hit_energy_map = hit_truth.IDHitEnergyMap(hits);
   }
 
   //#######################################################
@@ -1344,6 +1490,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   caf::SRTruthBranch                  srtruthbranch;
 
   if (mc_particles.isValid()) {
+    StageTimer truthParticlesTimer(fEnableMonitoring, fTiming.truthParticles);
     art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
     art::ServiceHandle<cheat::BackTrackerService> bt_serv;
 
@@ -1362,7 +1509,10 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     }
   }
 
-  std::vector<art::FindManyP<sbn::evwgh::EventWeightMap>> fmpewm;
+  // G4ID -> position in true_particles (and in *mc_particles)
+  const caf::TrueParticleIndex particle_index(true_particles);
+
+  std::vector<CachedFindManyP<sbn::evwgh::EventWeightMap>> fmpewm;
 
   // holder for invalid MCFlux
   simb::MCFlux badflux; // default constructor gives nonsense values
@@ -1384,21 +1534,29 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
     if ( !isRealData ){
 
+      StageTimer trueNeutrinoTimer(fEnableMonitoring, fTiming.trueNeutrinos);
       FillTrueNeutrino(mctruth, mcflux, gtruth, true_particles, id_to_truehit_map, srtruthbranch.nu.back(), i, fActiveVolumes);
+      trueNeutrinoTimer.Stop();
 
       srtruthbranch.nu.back().genie_evtrec_idx = fGenieEventCounter;
 
       // GENIE event record
       if(fSaveGENIEEventRecord){
         genie::EventRecord* genie_rec = evgb::RetrieveGHEP(*mctruth, gtruth);
-        if(fGenieTree){
-          fGenieEvtRec->Fill(fGenieEventCounter, genie_rec);
-          fGenieTree->Fill();
-        }
-        if(fFlatGenieTree){
-          fFlatGenieEvtRec->Fill(fGenieEventCounter, genie_rec);
-          fFlatGenieTree->Fill();
-        }
+        const unsigned int genieEntry = fGenieEventCounter;
+        const std::uint32_t sourceFileHash = fSourceFileHash;
+        fWriter->Submit([this, genie_rec, genieEntry, sourceFileHash] {
+            fGenieTreeEntry = genieEntry;
+            fGenieTreeSourceFileHash = sourceFileHash;
+            if(fGenieTree){
+              fGenieEvtRec->Fill(genieEntry, genie_rec);
+              fGenieTree->Fill();
+            }
+            if(fFlatGenieTree){
+              fFlatGenieEvtRec->Fill(genieEntry, genie_rec);
+              fFlatGenieTree->Fill();
+            }
+          });
       }
 
       fGenieEventCounter++;
@@ -1424,7 +1582,8 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
       // For all the weights associated with this MCTruth
       for(const art::Ptr<sbn::evwgh::EventWeightMap>& wgtmap: wgts){
-        FillEventWeight(*wgtmap, srtruthbranch.nu.back(), fWeightPSetIndex);
+        FillEventWeight(*wgtmap, srtruthbranch.nu.back(), fWeightPSetIndex,
+                        fParams.DropAllOnesSystWeights(), fParams.QuantizeSystWeights());
       } // end for wgtmap
     } // end for fm
   } // end for i (mctruths)
@@ -1443,7 +1602,8 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   }
 
   std::vector<caf::SRFakeReco> srfakereco;
-  FillFakeReco(mctruths, true_particles, mctracks, fActiveVolumes, fFakeRecoRandomEngine, srfakereco);
+  if (fSkim.Keep("fake_reco"))
+    FillFakeReco(mctruths, true_particles, particle_index, mctracks, fActiveVolumes, fFakeRecoRandomEngine, srfakereco);
 
   // Fill the MeVPrtl stuff
   for (unsigned i_prtl = 0; i_prtl < mevprtl_truths.size(); i_prtl++) {
@@ -1498,6 +1658,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
   // Fill various detector information associated with the event
 
+  StageTimer crtTimer(fEnableMonitoring, fTiming.crt);
   std::vector<caf::SRCRTHit> srcrthits;
   std::vector<caf::SRCRTTrack> srcrttracks;
   std::vector<caf::SRCRTSpacePoint> srcrtspacepoints;
@@ -1508,7 +1669,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       art::Handle<std::vector<sbn::crt::CRTHit>> crthits_handle;
       GetByLabelStrict(evt, fParams.CRTHitLabel(), crthits_handle);
       // fill into event
-      if (crthits_handle.isValid()) {
+      if (crthits_handle.isValid() && fSkim.Keep("crt_hits")) {
         const std::vector<sbn::crt::CRTHit> &crthits = *crthits_handle;
         for (unsigned i = 0; i < crthits.size(); i++) {
           srcrthits.emplace_back();
@@ -1519,7 +1680,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       art::Handle<std::vector<sbn::crt::CRTTrack>> crttracks_handle;
       GetByLabelStrict(evt, fParams.CRTTrackLabel(), crttracks_handle);
       // fill into event
-      if (crttracks_handle.isValid()) {
+      if (crttracks_handle.isValid() && fSkim.Keep("crt_tracks")) {
         const std::vector<sbn::crt::CRTTrack> &crttracks = *crttracks_handle;
         for (unsigned i = 0; i < crttracks.size(); i++) {
           srcrttracks.emplace_back();
@@ -1532,7 +1693,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       art::Handle<std::vector<sbnd::crt::CRTSpacePoint>> crtspacepoints_handle;
       GetByLabelStrict(evt, fParams.CRTSpacePointLabel(), crtspacepoints_handle);
 
-      if (crtspacepoints_handle.isValid()) {
+      if (crtspacepoints_handle.isValid() && fSkim.Keep("crt_spacepoints")) {
         const std::vector<sbnd::crt::CRTSpacePoint> &crtspacepoints = *crtspacepoints_handle;
         for (unsigned i = 0; i < crtspacepoints.size(); i++) {
           srcrtspacepoints.emplace_back();
@@ -1543,7 +1704,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       art::Handle<std::vector<sbnd::crt::CRTTrack>> sbndcrttracks_handle;
       GetByLabelStrict(evt, fParams.SBNDCRTTrackLabel(), sbndcrttracks_handle);
       // fill into event
-      if (sbndcrttracks_handle.isValid()) {
+      if (sbndcrttracks_handle.isValid() && fSkim.Keep("sbnd_crt_tracks")) {
         const std::vector<sbnd::crt::CRTTrack> &sbndcrttracks = *sbndcrttracks_handle;
         for (unsigned i = 0; i < sbndcrttracks.size(); i++) {
           srsbndcrttracks.emplace_back();
@@ -1556,7 +1717,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   std::vector<caf::SRCRTPMTMatch> srcrtpmtmatches;
   art::Handle<std::vector<sbn::crt::CRTPMTMatching>> crtpmtmatch_handle;
   GetByLabelStrict(evt, fParams.CRTPMTLabel(), crtpmtmatch_handle);
-  if(crtpmtmatch_handle.isValid()){
+  if(crtpmtmatch_handle.isValid() && fSkim.Keep("crtpmt_matches")){
     const std::vector<sbn::crt::CRTPMTMatching> &crtpmtmatches = *crtpmtmatch_handle;
     for (unsigned i = 0; i < crtpmtmatches.size(); i++) {
       int topen = 0, topex = 0, sideen = 0, sideex = 0; // bottomen = 0, bottomex = 0;
@@ -1567,15 +1728,17 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 		      srcrtpmtmatches.back());
     }
   }
+  crtTimer.Stop();
 
   // Get all of the OpFlashes
+  StageTimer opflashTimer(fEnableMonitoring, fTiming.opflash);
   std::vector<caf::SROpFlash> srflashes;
 
   for (const std::string& pandora_tag_suffix : pandora_tag_suffixes) {
     art::Handle<std::vector<recob::OpFlash>> flashes_handle;
     GetByLabelStrict(evt, fParams.OpFlashLabel() + pandora_tag_suffix, flashes_handle);
     // fill into event
-    if (flashes_handle.isValid()) {
+    if (flashes_handle.isValid() && fSkim.Keep("opflashes")) {
       const std::vector<recob::OpFlash> &opflashes = *flashes_handle;
       int cryostat = ( pandora_tag_suffix.find("W") != std::string::npos ) ? 1 : 0;
 
@@ -1593,6 +1756,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       }
     }
   }
+  opflashTimer.Stop();
 
   // collect the TPC slices
   std::vector<art::Ptr<recob::Slice>> slices;
@@ -1611,17 +1775,45 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       }
     }
   }
+  if (!fSkim.Keep("slc")) slices.clear();
 
   // The Standard Record
   // Branch entry definition -- contains list of slices, CRT information, and truth information
   StandardRecord rec;
 
+  // Hits kept from the reco fill of a slice for its truth matching.
+  //
+  // The truth matching goes through the BackTracker and ParticleInventory
+  // services and draws from the fake-reco random engine, so it always runs
+  // serially and in slice order, even when the reco fill is parallel.
+  struct SliceTruthHits {
+    std::vector<art::Ptr<recob::Hit>> slice;
+    std::vector<std::vector<art::Ptr<recob::Hit>>> stubs;
+    std::vector<std::vector<art::Ptr<recob::Hit>>> tracks;  ///< per PFP
+    std::vector<std::vector<art::Ptr<recob::Hit>>> showers; ///< per PFP
+    std::vector<bool> hasTrack;  ///< per PFP, whether to truth match the track
+    std::vector<bool> hasShower; ///< per PFP, whether to truth match the shower
+  };
+
+  // Sub-records of the slices dropped in a skim CAF
+  const bool fillSliceStubs = fSkim.Keep("slc.reco.stub");
+  const bool fillSliceHits = fSkim.Keep("slc.reco.hit");
+  const bool fillTrackCalo = fSkim.Keep("slc.reco.pfp.trk.calo");
+
+  // Track and shower fill times of a slice, for the monitoring tree
+  struct SlicePFPTiming {
+    float track = 0.f;
+    float shower = 0.f;
+  };
+
   //#######################################################
-  // Loop over slices
+  // Fill slice reco
   //#######################################################
-  for (unsigned sliceID = 0; sliceID < slices.size(); sliceID++) {
-    // Holder for information on this slice
-    caf::SRSlice recslc;
+  // Fills slice sliceID into recslc and returns whether it passes the
+  // selection. This only reads event products, so it is safe to run
+  // concurrently for different slices.
+  auto fillSliceReco = [&](unsigned sliceID, caf::SRSlice &recslc, SliceTruthHits &truthHits,
+                           SlicePFPTiming &pfpTiming) -> bool {
     recslc.truth.det = fDet;
 
     art::Ptr<recob::Slice> slice = slices[sliceID];
@@ -1630,7 +1822,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
     // Get tracks & showers here
     std::vector<art::Ptr<recob::Slice>> sliceList {slice};
-    art::FindManyP<recob::PFParticle> findManyPFParts =
+    CachedFindManyP<recob::PFParticle> findManyPFParts =
        FindManyPStrict<recob::PFParticle>(sliceList, evt,  fParams.PFParticleLabel() + slice_tag_suff);
 
     std::vector<art::Ptr<recob::PFParticle>> fmPFPart;
@@ -1638,7 +1830,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       fmPFPart = findManyPFParts.at(0);
     }
 
-    art::FindManyP<recob::Hit> fmSlcHits =
+    CachedFindManyP<recob::Hit> fmSlcHits =
       FindManyPStrict<recob::Hit>(sliceList, evt, fParams.PFParticleLabel() + slice_tag_suff);
 
     std::vector<art::Ptr<recob::Hit>> slcHits;
@@ -1646,7 +1838,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       slcHits = fmSlcHits.at(0);
     }
 
-    art::FindOneP<sbn::CRUMBSResult> foSlcCRUMBS =
+    CachedFindOneP<sbn::CRUMBSResult> foSlcCRUMBS =
       FindOnePStrict<sbn::CRUMBSResult>(sliceList, evt,
           fParams.CRUMBSLabel() + slice_tag_suff);
     const sbn::CRUMBSResult *slcCRUMBS = nullptr;
@@ -1654,7 +1846,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       slcCRUMBS = foSlcCRUMBS.at(0).get();
     }
 
-    std::map<std::string, art::FindManyP<sbn::SimpleFlashMatch> > fmatch_assn_map;
+    std::map<std::string, CachedFindManyP<sbn::SimpleFlashMatch> > fmatch_assn_map;
     std::vector<std::string> flashmatch_opdet_suffixes, flashmatch_scecryo_suffixes;
     fParams.FlashMatchOpDetSuffixes(flashmatch_opdet_suffixes);
     fParams.FlashMatchSCECryoSuffixes(flashmatch_scecryo_suffixes);
@@ -1662,33 +1854,33 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       std::string fname_opdet = fParams.FlashMatchLabel() + flash_opdet_suff;
       for(auto flash_scecryo_suff : flashmatch_scecryo_suffixes) {
         std::string fname_opdet_scecryo = fname_opdet + flash_scecryo_suff;
-        art::FindManyP<sbn::SimpleFlashMatch> sfm_assn =
+        CachedFindManyP<sbn::SimpleFlashMatch> sfm_assn =
           FindManyPStrict<sbn::SimpleFlashMatch>(fmPFPart, evt, fname_opdet_scecryo);
         fmatch_assn_map.emplace(std::make_pair(fname_opdet, sfm_assn));
       }
     }
 
-    art::FindManyP<sbn::OpT0Finder> fmOpT0 =
+    CachedFindManyP<sbn::OpT0Finder> fmOpT0 =
       FindManyPStrict<sbn::OpT0Finder>(sliceList, evt, fParams.OpT0Label() + slice_tag_suff);
     std::vector<art::Ptr<sbn::OpT0Finder>> slcOpT0;
     if (fmOpT0.isValid())
       slcOpT0 = fmOpT0.at(0);
 
-    art::FindManyP<sbn::SimpleFlashMatch> fm_sFM =
+    CachedFindManyP<sbn::SimpleFlashMatch> fm_sFM =
       FindManyPStrict<sbn::SimpleFlashMatch>(fmPFPart, evt,
                                              fParams.FlashMatchLabel() + slice_tag_suff);
 
-    art::FindOneP<sbn::TPCPMTBarycenterMatch> foTPCPMTBarycenterMatch =
+    CachedFindOneP<sbn::TPCPMTBarycenterMatch> foTPCPMTBarycenterMatch =
       FindOnePStrict<sbn::TPCPMTBarycenterMatch>(sliceList, evt,
           fParams.TPCPMTBarycenterMatchLabel() + slice_tag_suff);
     const sbn::TPCPMTBarycenterMatch *barycenterMatch
       = foTPCPMTBarycenterMatch.isValid()? foTPCPMTBarycenterMatch.at(0).get(): nullptr;
 
-    art::FindManyP<larpandoraobj::PFParticleMetadata> fmPFPMeta =
+    CachedFindManyP<larpandoraobj::PFParticleMetadata> fmPFPMeta =
       FindManyPStrict<larpandoraobj::PFParticleMetadata>(fmPFPart, evt,
                fParams.PFParticleLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::SpacePoint> fmSpacePoint =
+    CachedFindManyP<recob::SpacePoint> fmSpacePoint =
       FindManyPStrict<recob::SpacePoint>(slcHits, evt, fParams.PFParticleLabel() + slice_tag_suff);
 
     std::vector<art::Ptr<recob::SpacePoint>> slcSpacePoints;
@@ -1705,10 +1897,10 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       }
     }
 
-    art::FindManyP<recob::PFParticle> fmSpacePointPFPs =
+    CachedFindManyP<recob::PFParticle> fmSpacePointPFPs =
       FindManyPStrict<recob::PFParticle>(slcSpacePoints, evt, fParams.PFParticleLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::Shower> fmShower =
+    CachedFindManyP<recob::Shower> fmShower =
       FindManyPStrict<recob::Shower>(fmPFPart, evt, fParams.RecoShowerLabel() + slice_tag_suff);
 
     // make Ptr's to showers for shower -> other object associations
@@ -1726,23 +1918,23 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       }
     }
 
-    art::FindManyP<float> fmShowerCosmicDist =
+    CachedFindManyP<float> fmShowerCosmicDist =
       FindManyPStrict<float>(slcShowers, evt, fParams.ShowerCosmicDistLabel() + slice_tag_suff);
 
-    art::FindManyP<float> fmShowerResiduals =
+    CachedFindManyP<float> fmShowerResiduals =
       FindManyPStrict<float>(slcShowers, evt, fParams.RecoShowerSelectionLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::ShowerTrackFit> fmShowerTrackFit =
+    CachedFindManyP<sbn::ShowerTrackFit> fmShowerTrackFit =
       FindManyPStrict<sbn::ShowerTrackFit>(slcShowers, evt, fParams.RecoShowerSelectionLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::ShowerDensityFit> fmShowerDensityFit =
+    CachedFindManyP<sbn::ShowerDensityFit> fmShowerDensityFit =
       FindManyPStrict<sbn::ShowerDensityFit>(slcShowers, evt, fParams.RecoShowerSelectionLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::Track> fmTrack =
+    CachedFindManyP<recob::Track> fmTrack =
       FindManyPStrict<recob::Track>(fmPFPart, evt,
             fParams.RecoTrackLabel() + slice_tag_suff);
 
-    art::FindOneP<anab::T0> f1PFPT0 =
+    CachedFindOneP<anab::T0> f1PFPT0 =
       FindOnePStrict<anab::T0>(fmPFPart, evt,
             fParams.PFParticleLabel() + slice_tag_suff);
 
@@ -1762,7 +1954,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     }
 
     // Get the stubs!
-    art::FindManyP<sbn::Stub> fmSlcStubs =
+    CachedFindManyP<sbn::Stub> fmSlcStubs =
       FindManyPStrict<sbn::Stub>(sliceList, evt,
           fParams.StubLabel() + slice_tag_suff);
 
@@ -1772,85 +1964,85 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     }
 
     // Lookup stubs to overlaid PFP
-    art::FindManyP<recob::PFParticle> fmStubPFPs =
+    CachedFindManyP<recob::PFParticle> fmStubPFPs =
       FindManyPStrict<recob::PFParticle>(fmStubs, evt,
           fParams.StubLabel() + slice_tag_suff);
     // and get the stub hits for truth matching
-    art::FindManyP<recob::Hit> fmStubHits =
+    CachedFindManyP<recob::Hit> fmStubHits =
       FindManyPStrict<recob::Hit>(fmStubs, evt,
           fParams.StubLabel() + slice_tag_suff);
 
-    art::FindManyP<anab::Calorimetry> fmCalo =
+    CachedFindManyP<anab::Calorimetry> fmCalo =
       FindManyPStrict<anab::Calorimetry>(slcTracks, evt,
            fParams.TrackCaloLabel() + slice_tag_suff);
 
-    art::FindManyP<anab::ParticleID> fmChi2PID =
+    CachedFindManyP<anab::ParticleID> fmChi2PID =
       FindManyPStrict<anab::ParticleID>(slcTracks, evt,
           fParams.TrackChi2PidLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::ScatterClosestApproach> fmScatterClosestApproach =
+    CachedFindManyP<sbn::ScatterClosestApproach> fmScatterClosestApproach =
       FindManyPStrict<sbn::ScatterClosestApproach>(slcTracks, evt,
           fParams.TrackScatterClosestApproachLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::StoppingChi2Fit> fmStoppingChi2Fit =
+    CachedFindManyP<sbn::StoppingChi2Fit> fmStoppingChi2Fit =
       FindManyPStrict<sbn::StoppingChi2Fit>(slcTracks, evt,
           fParams.TrackStoppingChi2FitLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::MVAPID> fmTrackDazzle =
+    CachedFindManyP<sbn::MVAPID> fmTrackDazzle =
       FindManyPStrict<sbn::MVAPID>(slcTracks, evt,
           fParams.TrackDazzleLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::MVAPID> fmShowerRazzle =
+    CachedFindManyP<sbn::MVAPID> fmShowerRazzle =
       FindManyPStrict<sbn::MVAPID>(slcShowers, evt,
           fParams.ShowerRazzleLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::MVAPID> fmPFPRazzled =
+    CachedFindManyP<sbn::MVAPID> fmPFPRazzled =
       FindManyPStrict<sbn::MVAPID>(fmPFPart, evt,
           fParams.PFPRazzledLabel() + slice_tag_suff);
 
-    art::FindManyP<sbn::PFPCNNScore> fmCNNScores = 
+    CachedFindManyP<sbn::PFPCNNScore> fmCNNScores = 
       FindManyPStrict<sbn::PFPCNNScore>(fmPFPart, evt,
           fParams.CNNScoreLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::Vertex> fmVertex =
+    CachedFindManyP<recob::Vertex> fmVertex =
       FindManyPStrict<recob::Vertex>(fmPFPart, evt,
              fParams.PFParticleLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::Hit> fmTrackHit =
+    CachedFindManyP<recob::Hit> fmTrackHit =
       FindManyPStrict<recob::Hit>(slcTracks, evt,
           fParams.RecoTrackLabel() + slice_tag_suff);
 
-    art::FindManyP<recob::Hit> fmShowerHit =
+    CachedFindManyP<recob::Hit> fmShowerHit =
       FindManyPStrict<recob::Hit>(slcShowers, evt,
           fParams.RecoShowerLabel() + slice_tag_suff);
 
     // NOTE: The sbn::crt::CRTHit is associated to the T0. It's a bit awkward to
     // access that here, so we do it per-track (see code where fmCRTHitMatch is accessed below)
-    art::FindManyP<anab::T0> fmCRTHitMatch =
+    CachedFindManyP<anab::T0> fmCRTHitMatch =
       FindManyPStrict<anab::T0>(slcTracks, evt,
                fParams.CRTHitMatchLabel() + slice_tag_suff);
 
     // TODO: also save the sbn::crt::CRTTrack in the matching so that CAFMaker has access to it
-    art::FindManyP<anab::T0> fmCRTTrackMatch =
+    CachedFindManyP<anab::T0> fmCRTTrackMatch =
       FindManyPStrict<anab::T0>(slcTracks, evt,
                fParams.CRTTrackMatchLabel() + slice_tag_suff);
 
-    art::FindOneP<sbnd::crt::CRTSpacePoint, anab::T0> foCRTSpacePointMatch =
+    CachedFindOneP<sbnd::crt::CRTSpacePoint, anab::T0> foCRTSpacePointMatch =
       FindOnePDStrict<sbnd::crt::CRTSpacePoint, anab::T0>(slcTracks, evt,
                fParams.CRTSpacePointMatchLabel() + slice_tag_suff);
 
-    art::FindOneP<sbnd::crt::CRTTrack, anab::T0> foSBNDCRTTrackMatch =
+    CachedFindOneP<sbnd::crt::CRTTrack, anab::T0> foSBNDCRTTrackMatch =
       FindOnePDStrict<sbnd::crt::CRTTrack, anab::T0>(slcTracks, evt,
                fParams.SBNDCRTTrackMatchLabel() + slice_tag_suff);
 
-    std::vector<art::FindManyP<recob::MCSFitResult>> fmMCSs;
+    std::vector<CachedFindManyP<recob::MCSFitResult>> fmMCSs;
     static const std::vector<std::string> PIDnames {"muon", "pion", "kaon", "proton"};
     for (std::string pid: PIDnames) {
       art::InputTag tag(fParams.TrackMCSLabel() + slice_tag_suff, pid);
       fmMCSs.push_back(FindManyPStrict<recob::MCSFitResult>(slcTracks, evt, tag));
     }
 
-    std::vector<art::FindManyP<sbn::RangeP>> fmRanges;
+    std::vector<CachedFindManyP<sbn::RangeP>> fmRanges;
     static const std::vector<std::string> rangePIDnames {"muon", "pion", "proton"};
     for (std::string pid: rangePIDnames) {
       art::InputTag tag(fParams.TrackRangeLabel() + slice_tag_suff, pid);
@@ -1872,7 +2064,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     // get the flash match
 
     std::map<std::string, const sbn::SimpleFlashMatch*> fmatch_map;
-    std::map<std::string, art::FindManyP<sbn::SimpleFlashMatch>>::iterator fmatch_it;
+    std::map<std::string, CachedFindManyP<sbn::SimpleFlashMatch>>::iterator fmatch_it;
     for(fmatch_it = fmatch_assn_map.begin();fmatch_it != fmatch_assn_map.end();fmatch_it++) {
       auto fname = fmatch_it->first;
       auto fm_sFM = fmatch_it->second;
@@ -1911,7 +2103,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     FillTPCPMTBarycenterMatch(barycenterMatch, recslc);
 
     // select slice
-    if (!SelectSlice(recslc, fParams.CutClearCosmic())) continue;
+    if (!SelectSlice(recslc, fParams.CutClearCosmic())) return false;
 
     // Whether Pandora thinks this slice is a neutrino
     //
@@ -1919,17 +2111,8 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     // per-hit information about the slice.
     bool NeutrinoSlice = !recslc.is_clear_cosmic;
 
-    // Fill truth info after decision on selection is made
-    if ( !isRealData ) {
-      art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
-
-      FillSliceTruth(slcHits, mctruths, srtruthbranch,
-		     *pi_serv, clock_data, recslc);
-
-      FillSliceFakeReco(slcHits, mctruths, srtruthbranch,
-			*pi_serv, clock_data, recslc, true_particles, mctracks,
-                        fActiveVolumes, fFakeRecoRandomEngine);
-    }
+    // Truth info is filled after decision on selection is made
+    if ( !isRealData ) truthHits.slice = slcHits;
 
     //#######################################################
     // Add detector dependent slice info.
@@ -1942,23 +2125,20 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     //#######################################################
     // Add stub reconstructed objects.
     //#######################################################
-    for (size_t iStub = 0; iStub < fmStubs.size(); iStub++) {
+    for (size_t iStub = 0; fillSliceStubs && iStub < fmStubs.size(); iStub++) {
       const sbn::Stub &thisStub = *fmStubs[iStub];
 
       art::Ptr<recob::PFParticle> thisStubPFP;
       if (!fmStubPFPs.at(iStub).empty()) thisStubPFP = fmStubPFPs.at(iStub).at(0);
 
-      rec.reco.stub.emplace_back();
-      FillStubVars(thisStub, thisStubPFP, rec.reco.stub.back());
-      if ( !isRealData ) FillStubTruth(fmStubHits.at(iStub), id_to_hit_energy_map, true_particles, clock_data, rec.reco.stub.back());
-      rec.reco.nstub = rec.reco.stub.size();
-
-      // Duplicate stub reco info in the srslice
-      recslc.reco.stub.push_back(rec.reco.stub.back());
+      recslc.reco.stub.emplace_back();
+      FillStubVars(thisStub, thisStubPFP, recslc.reco.stub.back());
       recslc.reco.nstub = recslc.reco.stub.size();
+
+      if ( !isRealData ) truthHits.stubs.push_back(fmStubHits.at(iStub));
     }
 
-    if (fParams.FillHits()) {
+    if (fParams.FillHits() && fillSliceHits) {
       for ( size_t iHit = 0; iHit < slcHits.size(); ++iHit ) {
         const recob::Hit &thisHit = *slcHits[iHit];
 
@@ -1973,11 +2153,9 @@ void CAFMaker::produce(art::Event& evt) noexcept {
         if (!thisParticle.empty() && !thisPoint.empty()) {
           assert(thisParticle.size() == 1);
           assert(thisPoint.size() == 1);
-          rec.reco.nhit++;
-          rec.reco.hit.push_back(SRHit());
+          recslc.reco.hit.push_back(SRHit());
 
-          FillHitVars(thisHit, producer, *thisPoint[0], *thisParticle[0], rec.reco.hit.back());
-          recslc.reco.hit.push_back(rec.reco.hit.back());
+          FillHitVars(thisHit, producer, *thisPoint[0], *thisParticle[0], recslc.reco.hit.back());
           recslc.reco.nhit = recslc.reco.hit.size();
         }
       }
@@ -1988,6 +2166,10 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     //#######################################################
     // Reco objects have assns to the slice PFParticles
     // This depends on the findMany object created above.
+    truthHits.tracks.resize(fmPFPart.size());
+    truthHits.showers.resize(fmPFPart.size());
+    truthHits.hasTrack.resize(fmPFPart.size(), false);
+    truthHits.hasShower.resize(fmPFPart.size(), false);
     for ( size_t iPart = 0; iPart < fmPFPart.size(); ++iPart ) {
       const recob::PFParticle &thisParticle = *fmPFPart[iPart];
       std::vector<art::Ptr<recob::Track>> thisTrack;
@@ -2016,6 +2198,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
       if (!thisTrack.empty())  { // it has a track!
         assert(thisTrack.size() == 1);
+        StageTimer trackTimer(fEnableMonitoring, pfpTiming.track);
 
         // collect all the stuff
         std::array<std::vector<art::Ptr<recob::MCSFitResult>>, 4> trajectoryMCS;
@@ -2060,14 +2243,14 @@ void CAFMaker::produce(art::Event& evt) noexcept {
         if (fmTrackDazzle.isValid() && fmTrackDazzle.at(iPart).size()==1) {
            FillTrackDazzle(fmTrackDazzle.at(iPart).front(), trk);
         }
-        if (fmCalo.isValid()) {
+        if (fmCalo.isValid() && fillTrackCalo) {
           FillTrackCalo(fmCalo.at(iPart), fmTrackHit.at(iPart),
               (fParams.FillHitsNeutrinoSlices() && NeutrinoSlice) || fParams.FillHitsAllSlices(),
               fParams.TrackHitFillRRStartCut(), fParams.TrackHitFillRREndCut(),
               dprop, trk);
         }
         if (fmCRTHitMatch.isValid() && fDet == kICARUS) {
-          art::FindManyP<sbn::crt::CRTHit> CRTT02Hit = FindManyPStrict<sbn::crt::CRTHit>
+          CachedFindManyP<sbn::crt::CRTHit> CRTT02Hit = FindManyPStrict<sbn::crt::CRTHit>
               (fmCRTHitMatch.at(iPart), evt, fParams.CRTHitMatchLabel() + slice_tag_suff);
 
           std::vector<art::Ptr<sbn::crt::CRTHit>> crthitmatch;
@@ -2096,19 +2279,15 @@ void CAFMaker::produce(art::Event& evt) noexcept {
           }
 
         // Truth matching
-        if (fmTrackHit.isValid()) {
-          if ( !isRealData ) {
-            // Track -> particle matching
-            FillTrackTruth(fmTrackHit.at(iPart), id_to_hit_energy_map, true_particles, clock_data, trk);
-            // Hit truth information corresponding to Calo-Points
-            // Assumes truth matching and calo-points are filled
-            if (mc_particles.isValid() && fParams.FillTrackCaloTruth()) FillTrackCaloTruth(id_to_ide_map, *mc_particles, *geom, wireReadout, clock_data, sce, trk);
-          }
+        if (fmTrackHit.isValid() && !isRealData) {
+          truthHits.tracks[iPart] = fmTrackHit.at(iPart);
+          truthHits.hasTrack[iPart] = true;
         }
       } // thisTrack exists
 
       if (!thisShower.empty()) { // it has shower!
         assert(thisShower.size() == 1);
+        StageTimer showerTimer(fEnableMonitoring, pfpTiming.shower);
 
         SRShower& shw = pfp.shw;
         FillShowerVars(*thisShower[0], vertex, fmShowerHit.at(iPart), wireReadout, producer, shw);
@@ -2129,8 +2308,9 @@ void CAFMaker::produce(art::Event& evt) noexcept {
         if (fmShowerDensityFit.isValid() && fmShowerDensityFit.at(iPart).size() == 1) {
           FillShowerDensityFit(*fmShowerDensityFit.at(iPart).front(), shw);
         }
-        if (fmShowerHit.isValid()) {
-          if ( !isRealData ) FillShowerTruth(fmShowerHit.at(iPart), id_to_hit_energy_map, true_particles, clock_data, shw);
+        if (fmShowerHit.isValid() && !isRealData) {
+          truthHits.showers[iPart] = fmShowerHit.at(iPart);
+          truthHits.hasShower[iPart] = true;
         }
 
       } // thisShower exists
@@ -2139,27 +2319,119 @@ void CAFMaker::produce(art::Event& evt) noexcept {
       recslc.reco.npfp = recslc.reco.pfp.size();
     }// end for pfparts
 
+    return true;
+  }; // fillSliceReco
 
+  //#######################################################
+  // Fill slice truth
+  //#######################################################
+  auto fillSliceTruth = [&](caf::SRSlice &recslc, const SliceTruthHits &truthHits) {
+    art::ServiceHandle<cheat::ParticleInventoryService> pi_serv;
 
-    //#######################################################
-    // Fill slice in rec tree
-    //#######################################################
+    FillSliceTruth(truthHits.slice, mctruths, srtruthbranch,
+                   *pi_serv, hit_truth, recslc);
 
-    // // Set mc branch values to default
-    // rec.mc.setDefault();
-    // if (fParams.EnableBlindness()) BlindThisRecord(&rec);
-    //util::CreateAssn(*this, evt, *srcol, art::Ptr<recob::Slice>(slices, sliceID),
-    //                 *srAssn);
+    FillSliceFakeReco(truthHits.slice, mctruths, srtruthbranch,
+                      *pi_serv, hit_truth, recslc, true_particles, particle_index, mctracks,
+                      fActiveVolumes, fFakeRecoRandomEngine);
 
-    rec.slc.push_back(recslc);
+    for (size_t iStub = 0; iStub < truthHits.stubs.size(); iStub++) {
+      FillStubTruth(truthHits.stubs[iStub], id_to_hit_energy_map, true_particles, particle_index, hit_truth, recslc.reco.stub[iStub]);
+    }
 
-  }  // end loop over slices
+    for (size_t iPart = 0; iPart < recslc.reco.pfp.size(); iPart++) {
+      if (truthHits.hasTrack[iPart]) {
+        SRTrack& trk = recslc.reco.pfp[iPart].trk;
+        // Track -> particle matching
+        FillTrackTruth(truthHits.tracks[iPart], id_to_hit_energy_map, true_particles, particle_index, hit_truth, trk);
+        // Hit truth information corresponding to Calo-Points
+        // Assumes truth matching and calo-points are filled
+        if (mc_particles.isValid() && fParams.FillTrackCaloTruth()) FillTrackCaloTruth(id_to_ide_map, *mc_particles, particle_index, *geom, wireReadout, clock_data, sce, trk);
+      }
+      if (truthHits.hasShower[iPart]) {
+        FillShowerTruth(truthHits.showers[iPart], id_to_hit_energy_map, true_particles, particle_index, hit_truth, recslc.reco.pfp[iPart].shw);
+      }
+    }
+  }; // fillSliceTruth
+
+  //#######################################################
+  // Fill slice in rec tree
+  //#######################################################
+  // Stubs and hits are duplicated at the event level, in slice order
+  const bool keepEventStubs = fSkim.Keep("reco.stub");
+  const bool keepEventHits = fSkim.Keep("reco.hit");
+  auto addSlice = [&rec, keepEventStubs, keepEventHits](caf::SRSlice &&recslc) {
+    if (keepEventStubs) {
+      for (const SRStub &stub: recslc.reco.stub) {
+        rec.reco.stub.push_back(stub);
+        rec.reco.nstub = rec.reco.stub.size();
+      }
+    }
+    if (keepEventHits) {
+      for (const SRHit &hit: recslc.reco.hit) {
+        rec.reco.nhit++;
+        rec.reco.hit.push_back(hit);
+      }
+    }
+    rec.slc.push_back(std::move(recslc));
+  };
+
+  if (fParams.ParallelSliceFill()) {
+    // Fill the reco of all slices concurrently into preallocated slots, then
+    // do the truth matching and merge them in the original order so the
+    // output is identical to the serial path
+    std::vector<caf::SRSlice> slcSlots(slices.size());
+    std::vector<SliceTruthHits> truthSlots(slices.size());
+    std::vector<SlicePFPTiming> timingSlots(slices.size());
+    std::vector<char> selected(slices.size(), 0); // not vector<bool>: written concurrently
+
+    StageTimer sliceRecoTimer(fEnableMonitoring, fTiming.sliceReco);
+    tbb::parallel_for(tbb::blocked_range<unsigned>(0, slices.size()),
+      [&](const tbb::blocked_range<unsigned> &range) {
+        for (unsigned sliceID = range.begin(); sliceID != range.end(); sliceID++) {
+          selected[sliceID] = fillSliceReco(sliceID, slcSlots[sliceID], truthSlots[sliceID], timingSlots[sliceID]);
+        }
+      });
+    sliceRecoTimer.Stop();
+
+    for (unsigned sliceID = 0; sliceID < slices.size(); sliceID++) {
+      fTiming.pfpTrack += timingSlots[sliceID].track;
+      fTiming.pfpShower += timingSlots[sliceID].shower;
+      if (!selected[sliceID]) continue;
+      if ( !isRealData ) {
+        StageTimer truthTimer(fEnableMonitoring, fTiming.truthMatching);
+        fillSliceTruth(slcSlots[sliceID], truthSlots[sliceID]);
+      }
+      addSlice(std::move(slcSlots[sliceID]));
+    }
+  }
+  else {
+    for (unsigned sliceID = 0; sliceID < slices.size(); sliceID++) {
+      // Holder for information on this slice
+      caf::SRSlice recslc;
+      SliceTruthHits truthHits;
+      SlicePFPTiming pfpTiming;
+      StageTimer sliceRecoTimer(fEnableMonitoring, fTiming.sliceReco);
+      const bool pass = fillSliceReco(sliceID, recslc, truthHits, pfpTiming);
+      sliceRecoTimer.Stop();
+      fTiming.pfpTrack += pfpTiming.track;
+      fTiming.pfpShower += pfpTiming.shower;
+      if (!pass) continue;
+      if ( !isRealData ) {
+        StageTimer truthTimer(fEnableMonitoring, fTiming.truthMatching);
+        fillSliceTruth(recslc, truthHits);
+      }
+      addSlice(std::move(recslc));
+    }
+  }
 
   //#######################################################
   //  Fill rec Tree
   //#######################################################
   rec.nslc             = rec.slc.size();
-  rec.mc               = srtruthbranch;
+  if (fSkim.Keep("mc")) {
+    rec.mc             = srtruthbranch;
+  }
   rec.fake_reco        = srfakereco;
   rec.nfake_reco       = srfakereco.size();
   rec.pass_flashtrig   = pass_flash_trig;  // trigger result
@@ -2173,7 +2445,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
   rec.nsbnd_crt_tracks = srsbndcrttracks.size();
   rec.opflashes        = srflashes;
   rec.nopflashes       = srflashes.size();
-  if (fParams.FillTrueParticles()) {
+  if (fParams.FillTrueParticles() && fSkim.Keep("true_particles")) {
     rec.true_particles  = true_particles;
   }
   rec.ntrue_particles = true_particles.size();
@@ -2286,76 +2558,114 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     std::cout << "Did not find this event in the spill info map." << std::endl;
   }
 
+  StageTimer writeTimer(fEnableMonitoring, fTiming.treeWrite);
   if(fRecTree){
-    // Save the standard-record
-    StandardRecord* prec = &rec;
-    fRecTree->SetBranchAddress("rec", &prec);
-    fRecTree->Fill();
-
-    if(fFlatTree){
-      fFlatRecord->Clear();
-      fFlatRecord->Fill(rec);
-      fFlatTree->Fill();
-    }
+    // The trees are filled by fWriter, possibly on its own thread, so it
+    // takes ownership of the record. Everything that depends on the module
+    // state (random numbers, first-in-subrun flags, counters) is decided here.
+    //
+    // With BlindStreamsInPlace, the blind and prescale streams are written
+    // from the same record once the unblinded trees have been filled, by
+    // overriding its header (and blinding it in place). Otherwise they are
+    // written from a deep copy of the record, made here.
+    auto prec = std::make_shared<StandardRecord>(std::move(rec));
+    enum class Stream { kNone, kPrescale, kBlind } stream = Stream::kNone;
+    SRHeader streamhdr;
+    std::shared_ptr<StandardRecord> pstreamrec; ///< The copy for the stream, if not in place
 
     //Generate random number to decide if event is saved in prescale or blinded file
     if (fParams.CreateBlindedCAF()) {
       CLHEP::RandFlat uniformGen{ fBlindRandomEngine };
       const bool keepprescale = uniformGen.fire() < 1/fParams.PrescaleFactor();
-      rec.hdr.evt = 0;
-      rec.hdr.isblind = true;
+      streamhdr = prec->hdr;
+      streamhdr.isblind = true;
+      streamhdr.evt = evtID;
       if (keepprescale) {
         mf::LogVerbatim("CAFMaker") << "CAFMaker: " << evt.id() << " is not blinded.";
-        StandardRecord* precp = new StandardRecord (*prec);
+        stream = Stream::kPrescale;
         if (fFirstPrescaleInSubRun) {
-          precp->hdr.pot = fSubRunPOT*(1/fParams.PrescaleFactor());
-          precp->hdr.first_in_file = fFirstPrescaleInFile;
-          precp->hdr.first_in_subrun = true;
-          precp->hdr.nbnbinfo = fBNBInfo.size()*(1/fParams.PrescaleFactor());
-          precp->hdr.nnumiinfo = fNuMIInfo.size()*(1/fParams.PrescaleFactor());
+          streamhdr.pot = fSubRunPOT*(1/fParams.PrescaleFactor());
+          streamhdr.first_in_file = fFirstPrescaleInFile;
+          streamhdr.first_in_subrun = true;
+          streamhdr.nbnbinfo = fBNBInfo.size()*(1/fParams.PrescaleFactor());
+          streamhdr.nnumiinfo = fNuMIInfo.size()*(1/fParams.PrescaleFactor());
         }
-        precp->hdr.ngenevt = n_gen_evt*(1/fParams.PrescaleFactor());
-        precp->hdr.evt = evtID;
-        fRecTreep->SetBranchAddress("rec", &precp);
-        fRecTreep->Fill();
+        streamhdr.ngenevt = n_gen_evt*(1/fParams.PrescaleFactor());
         fPrescaleEvents += 1;
-        if (fFlatTreep) {
-          fFlatRecordp->Clear();
-          fFlatRecordp->Fill(*precp);
-          fFlatTreep->Fill();
-        }
         fFirstPrescaleInFile = false;
         fFirstPrescaleInSubRun = false;
       }
       else {
-        StandardRecord* precb = new StandardRecord (*prec);
-        BlindEnergyParameters(precb);
+        stream = Stream::kBlind;
         if (fFirstBlindInSubRun) {
-          precb->hdr.pot = fSubRunPOT*(1-(1/fParams.PrescaleFactor()))*GetBlindPOTScale();
-          precb->hdr.first_in_file = fFirstBlindInFile;
-          precb->hdr.first_in_subrun = true;
-          precb->hdr.nbnbinfo = fBNBInfo.size()*(1 - (1/fParams.PrescaleFactor()));
-          precb->hdr.nnumiinfo = fNuMIInfo.size()*(1-(1/fParams.PrescaleFactor()));
+          streamhdr.pot = fSubRunPOT*(1-(1/fParams.PrescaleFactor()))*GetBlindPOTScale();
+          streamhdr.first_in_file = fFirstBlindInFile;
+          streamhdr.first_in_subrun = true;
+          streamhdr.nbnbinfo = fBNBInfo.size()*(1 - (1/fParams.PrescaleFactor()));
+          streamhdr.nnumiinfo = fNuMIInfo.size()*(1-(1/fParams.PrescaleFactor()));
         }
-        precb->hdr.ngenevt = n_gen_evt*(1 - (1/fParams.PrescaleFactor()));
-        precb->hdr.evt = evtID;
-        fRecTreeb->SetBranchAddress("rec", &precb);
-        fRecTreeb->Fill();
+        streamhdr.ngenevt = n_gen_evt*(1 - (1/fParams.PrescaleFactor()));
         fBlindEvents += 1;
-        if (fFlatTreeb) {
-          fFlatRecordb->Clear();
-          fFlatRecordb->Fill(*precb);
-          fFlatTreeb->Fill();
-        }
         fFirstBlindInFile = false;
         fFirstBlindInSubRun = false;
       }
+
+      if (!fParams.BlindStreamsInPlace()) {
+        pstreamrec = std::make_shared<StandardRecord>(*prec);
+        if (stream == Stream::kBlind) BlindEnergyParameters(pstreamrec.get());
+        pstreamrec->hdr = std::move(streamhdr);
+      }
+    }
+
+    // The writer modifies the record, so take the art product copy first
+    srcol->push_back(*prec);
+    if (fParams.CreateBlindedCAF()) {
+      srcol->back().hdr.evt = 0;
+      srcol->back().hdr.isblind = true;
     }
+
+    fWriter->Submit([this, prec, pstreamrec, stream, streamhdr = std::move(streamhdr)]() mutable {
+        // Save the standard-record
+        StandardRecord* ptr = prec.get();
+        fRecTree->SetBranchAddress("rec", &ptr);
+        fRecTree->Fill();
+
+        if(fFlatTree){
+          fFlatRecord->Clear();
+          fFlatRecord->Fill(*prec);
+          fFlatTree->Fill();
+        }
+
+        if (stream == Stream::kNone) return;
+
+        if (pstreamrec) {
+          ptr = pstreamrec.get();
+        }
+        else {
+          prec->hdr = std::move(streamhdr);
+          if (stream == Stream::kBlind) BlindEnergyParameters(prec.get());
+        }
+
+        TTree* tree = (stream == Stream::kBlind) ? fRecTreeb : fRecTreep;
+        tree->SetBranchAddress("rec", &ptr);
+        tree->Fill();
+
+        TTree* flatTree = (stream == Stream::kBlind) ? fFlatTreeb : fFlatTreep;
+        flat::Flat<caf::StandardRecord>* flatRecord = (stream == Stream::kBlind) ? fFlatRecordb : fFlatRecordp;
+        if (flatTree) {
+          flatRecord->Clear();
+          flatRecord->Fill(*ptr);
+          flatTree->Fill();
+        }
+      });
+  }
+  else {
+    srcol->push_back(std::move(rec));
   }
+  writeTimer.Stop();
 
 // reset
   fFirstInSubRun = false;
-  srcol->push_back(rec);
   evt.put(std::move(srcol));
 
   // Only clear these if we've filled into all file types
@@ -2364,6 +2674,37 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     fNuMIInfo.clear();
     rec.hdr.pot = 0;
   }
+
+  // Don't hold on to indices of this event's products
+  fAssnCache.Clear();
+
+  if (fEnableMonitoring) {
+    totalTimer.Stop();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fTimingMaxRSS = usage.ru_maxrss / 1024.; // kB -> MB
+
+    // ROOT may be writing the CAF trees on the writer thread right now, so
+    // the timing tree is filled there too
+    const TimingEntry entry{int(evt.run()), int(evt.event()), fTimingMaxRSS, fTiming};
+    fWriter->Submit([this, entry] {
+        fTimingEntry = entry;
+        fTimingTree->Fill();
+      });
+
+    fTimingSum.truthParticles += fTiming.truthParticles;
+    fTimingSum.trueNeutrinos += fTiming.trueNeutrinos;
+    fTimingSum.crt += fTiming.crt;
+    fTimingSum.opflash += fTiming.opflash;
+    fTimingSum.sliceReco += fTiming.sliceReco;
+    fTimingSum.pfpTrack += fTiming.pfpTrack;
+    fTimingSum.pfpShower += fTiming.pfpShower;
+    fTimingSum.truthMatching += fTiming.truthMatching;
+    fTimingSum.treeWrite += fTiming.treeWrite;
+    fTimingSum.total += fTiming.total;
+    fTimingEvents++;
+  }
 }
 
 void CAFMaker::endSubRun(art::SubRun& sr) {
@@ -2405,6 +2746,25 @@ void CAFMaker::endSubRun(art::SubRun& sr) {
 
 //......................................................................
 void CAFMaker::endJob() {
+  // All the trees have to be complete before the files are written
+  fWriter->Flush();
+
+  if (fEnableMonitoring && fTimingEvents > 0) {
+    const double n = fTimingEvents;
+    mf::LogInfo("CAFMaker") << "*** CAFMaker mean time per event over " << fTimingEvents << " events [s]:"
+                            << "\n    truth particles: " << fTimingSum.truthParticles / n
+                            << "\n    true neutrinos:  " << fTimingSum.trueNeutrinos / n
+                            << "\n    CRT:             " << fTimingSum.crt / n
+                            << "\n    OpFlash:         " << fTimingSum.opflash / n
+                            << "\n    slice reco:      " << fTimingSum.sliceReco / n
+                            << "\n      PFP tracks:    " << fTimingSum.pfpTrack / n
+                            << "\n      PFP showers:   " << fTimingSum.pfpShower / n
+                            << "\n    truth matching:  " << fTimingSum.truthMatching / n
+                            << "\n    tree writes:     " << fTimingSum.treeWrite / n
+                            << "\n    total:           " << fTimingSum.total / n
+                            << "\n    peak RSS [MB]:   " << fTimingMaxRSS;
+  }
+
   if (fTotalEvents == 0) {
 
     std::cerr << "No events processed in this file. Aborting rather than "
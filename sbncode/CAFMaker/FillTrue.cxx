@@ -1,6 +1,8 @@
 #include "FillTrue.h"
 
-#include "larcorealg/GeoAlgo/GeoAlgo.h"
+#include "sbncode/OpT0Finder/flashmatch/GeoAlgo/GeoSlab.h"
+#include "sbncode/SBNEventWeight/Base/WeightCompression.h"
+#include "sbncode/CAFMaker/G4ProcessTable.h"
 #include "larcorealg/Geometry/GeometryCore.h"
 #include "larcorealg/Geometry/WireReadoutGeom.h"
 #include "larevt/SpaceCharge/SpaceCharge.h"
@@ -11,20 +13,22 @@
 
 #include <functional>
 #include <algorithm>
+#include <array>
 
 // helper function declarations
 
-caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const std::vector<caf::SRTrueParticle> &particles, const std::vector<art::Ptr<recob::Hit>> &hits,
+caf::SRTrackTruth MatchTrack2Truth(const caf::HitTruthTable &hit_truth, const std::vector<caf::SRTrueParticle> &particles,
+                                   const caf::TrueParticleIndex &particle_index, const std::vector<art::Ptr<recob::Hit>> &hits,
 				   const std::map<int, caf::HitsEnergy> &all_hits_map);
 
 caf::SRTruthMatch MatchSlice2Truth(const std::vector<art::Ptr<recob::Hit>> &hits,
                                    const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                                    const caf::SRTruthBranch &srtruth,
                                    const cheat::ParticleInventoryService &inventory_service,
-                                   const detinfo::DetectorClocksData &clockData);
+                                   const caf::HitTruthTable &hit_truth);
 
 float ContainedLength(const TVector3 &v0, const TVector3 &v1,
-                      const std::vector<geoalgo::AABox> &boxes);
+                      const std::vector<geoalgo::SlabBox> &boxes);
 
 bool FRFillNumuCC(const simb::MCTruth &mctruth,
                   const std::vector<art::Ptr<sim::MCTrack>> &mctracks,
@@ -33,6 +37,7 @@ bool FRFillNumuCC(const simb::MCTruth &mctruth,
                   caf::SRFakeReco &fakereco);
 bool FRFillNueCC(const simb::MCTruth &mctruth,
                   const std::vector<caf::SRTrueParticle> &srparticle,
+                  const caf::TrueParticleIndex &particle_index,
                   const std::vector<geo::BoxBoundedGeo> &volumes,
                   CLHEP::HepRandomEngine &rand,
                   caf::SRFakeReco &fakereco);
@@ -126,18 +131,20 @@ namespace caf {
   void FillTrackTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                       const std::map<int, caf::HitsEnergy> &id_hits_map,
                       const std::vector<caf::SRTrueParticle> &particles,
-                      const detinfo::DetectorClocksData &clockData,
+                      const caf::TrueParticleIndex &particle_index,
+                      const caf::HitTruthTable &hit_truth,
                       caf::SRTrack& srtrack,
                       bool allowEmpty)
   {
     // Truth matching
-    srtrack.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srtrack.truth = MatchTrack2Truth(hit_truth, particles, particle_index, hits, id_hits_map);
 
   }//FillTrackTruth
 
   // Assumes truth matching and calo-points are filled
-  void FillTrackCaloTruth(const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> &id_to_ide_map,
+  void FillTrackCaloTruth(const caf::IDEMap &id_to_ide_map,
                           const std::vector<simb::MCParticle> &mc_particles,
+                          const caf::TrueParticleIndex &particle_index,
                           const geo::GeometryCore& geometry,
                           const geo::WireReadoutGeom& wireReadout,
                           const detinfo::DetectorClocksData &clockData,
@@ -148,22 +155,17 @@ namespace caf {
 
     // require track to be truth matched
     if (srtrack.truth.p.G4ID < 0) return;
-    if (!id_to_ide_map.count(srtrack.truth.p.G4ID)) return;
+    const caf::IDEMap::Range match_ides = id_to_ide_map.Find(srtrack.truth.p.G4ID);
+    if (match_ides.empty()) return;
 
     // Look up the true particle trajectory
-    const simb::MCParticle *match = NULL;
-    for (const simb::MCParticle &p: mc_particles) {
-      if (p.TrackId() == srtrack.truth.p.G4ID) {
-        match = &p;
-        break;
-      }
-    }
-    if (!match) return;
-    const simb::MCParticle &particle = *match;
+    const int i_match = particle_index.Find(srtrack.truth.p.G4ID);
+    if (i_match < 0 || i_match >= (int)mc_particles.size()) return;
+    const simb::MCParticle &particle = mc_particles[i_match];
+    assert(particle.TrackId() == srtrack.truth.p.G4ID);
 
     // Load the hits
     // match on the channel, which is unique
-    const std::vector<std::pair<geo::WireID, const sim::IDE*>> &match_ides = id_to_ide_map.at(srtrack.truth.p.G4ID);
     std::map<unsigned, std::vector<const sim::IDE *>> chan_2_ides;
     for (auto const &ide_pair: match_ides) {
       chan_2_ides[wireReadout.PlaneWireToChannel(ide_pair.first)].push_back(ide_pair.second);
@@ -332,12 +334,13 @@ namespace caf {
   void FillShowerTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                        const std::map<int, caf::HitsEnergy> &id_hits_map,
                        const std::vector<caf::SRTrueParticle> &particles,
-                       const detinfo::DetectorClocksData &clockData,
+                       const caf::TrueParticleIndex &particle_index,
+                       const caf::HitTruthTable &hit_truth,
                        caf::SRShower& srshower,
                        bool allowEmpty)
   {
     // Truth matching
-    srshower.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srshower.truth = MatchTrack2Truth(hit_truth, particles, particle_index, hits, id_hits_map);
 
   }//FillShowerTruth
 
@@ -345,11 +348,12 @@ namespace caf {
   void FillStubTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                      const std::map<int, caf::HitsEnergy> &id_hits_map,
                      const std::vector<caf::SRTrueParticle> &particles,
-                     const detinfo::DetectorClocksData &clockData,
+                     const caf::TrueParticleIndex &particle_index,
+                     const caf::HitTruthTable &hit_truth,
                      caf::SRStub& srstub,
                      bool allowEmpty) 
   {
-    srstub.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srstub.truth = MatchTrack2Truth(hit_truth, particles, particle_index, hits, id_hits_map);
   }
 
 
@@ -359,12 +363,12 @@ namespace caf {
                       const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                       const caf::SRTruthBranch &srmc,
                       const cheat::ParticleInventoryService &inventory_service,
-                      const detinfo::DetectorClocksData &clockData,
+                      const caf::HitTruthTable &hit_truth,
                       caf::SRSlice &srslice, 
                       bool allowEmpty)
   {
 
-    caf::SRTruthMatch tmatch = MatchSlice2Truth(hits, neutrinos, srmc, inventory_service, clockData);
+    caf::SRTruthMatch tmatch = MatchSlice2Truth(hits, neutrinos, srmc, inventory_service, hit_truth);
 
     if (tmatch.index >= 0) {
       srslice.truth = srmc.nu[tmatch.index];
@@ -438,18 +442,19 @@ namespace caf {
                          const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                          const caf::SRTruthBranch &srmc,
                          const cheat::ParticleInventoryService &inventory_service,
-                         const detinfo::DetectorClocksData &clockData,
+                         const caf::HitTruthTable &hit_truth,
                          caf::SRSlice &srslice,
                          const std::vector<caf::SRTrueParticle> &srparticles,
+                         const caf::TrueParticleIndex &particle_index,
                          const std::vector<art::Ptr<sim::MCTrack>> &mctracks,
                          const std::vector<geo::BoxBoundedGeo> &volumes,
                          CLHEP::HepRandomEngine &rand)
   {
-    caf::SRTruthMatch tmatch = MatchSlice2Truth(hits, neutrinos, srmc, inventory_service, clockData);
+    caf::SRTruthMatch tmatch = MatchSlice2Truth(hits, neutrinos, srmc, inventory_service, hit_truth);
     if(tmatch.index >= 0) {
       FRFillNumuCC(*neutrinos[tmatch.index], mctracks, volumes, rand, srslice.fake_reco);
       if(!srslice.fake_reco.filled)
-        FRFillNueCC(*neutrinos[tmatch.index], srparticles, volumes, rand, srslice.fake_reco);
+        FRFillNueCC(*neutrinos[tmatch.index], srparticles, particle_index, volumes, rand, srslice.fake_reco);
     }
   }//FillSliceFakeReco
 
@@ -459,7 +464,7 @@ namespace caf {
       const simb::MCFlux &mcflux,
       const simb::GTruth& gtruth,
       const std::vector<caf::SRTrueParticle> &srparticles,
-      const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
+      const caf::TrueHitMap &id_to_truehit_map,
       caf::SRTrueInteraction &srneutrino, size_t i,
       const std::vector<geo::BoxBoundedGeo> &active_volumes) {
 
@@ -498,8 +503,7 @@ namespace caf {
         if (srparticles[i_part].start_process == caf::kG4primary && srparticles[i_part].interaction_id == (int)i) {
           int track_id = srparticles[i_part].G4ID;
           // Look for hits
-          if (!id_to_truehit_map.count(track_id)) continue;
-          for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.at(track_id)) {
+          for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.Find(track_id)) {
             if (!h->WireID()) continue;
             planehitIDs[h->WireID().Cryostat][h->WireID().Plane].insert(h.key());
           }
@@ -520,8 +524,7 @@ namespace caf {
         if (srparticles[i_part].interaction_id == (int)i) {
           int track_id = srparticles[i_part].G4ID;
           // Look for hits
-          if (!id_to_truehit_map.count(track_id)) continue;
-          for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.at(track_id)) {
+          for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.Find(track_id)) {
             if (!h->WireID()) continue;
             planehitIDs[h->WireID().Cryostat][h->WireID().Plane].insert(h.key());
           }
@@ -613,7 +616,9 @@ namespace caf {
 
   void FillEventWeight(const sbn::evwgh::EventWeightMap& wgtmap,
                        caf::SRTrueInteraction& srint,
-                       const std::map<std::string, unsigned int>& weightPSetIndex)
+                       const std::map<std::string, unsigned int>& weightPSetIndex,
+                       bool dropAllOnes,
+                       bool quantize)
   {
     for(auto& it: wgtmap){
       if(weightPSetIndex.count(it.first) == 0){
@@ -625,7 +630,15 @@ namespace caf {
 
       const unsigned int idx = weightPSetIndex.at(it.first);
       if(idx >= srint.wgt.size()) srint.wgt.resize(idx+1);
-      srint.wgt[idx].univ = it.second;
+      std::vector<float>& univ = srint.wgt[idx].univ;
+      // A single weight stands for the weight of all the nuniv universes.
+      // Empty stays empty, as calculators may legitimately give no weights
+      if(dropAllOnes && sbn::evwgh::AllOnes(it.second)){
+        univ.assign(1, 1.f);
+        continue;
+      }
+      univ = it.second;
+      if(quantize) sbn::evwgh::QuantizeWeights(univ);
     }
   }
 
@@ -634,18 +647,15 @@ namespace caf {
   void FillTrueG4Particle(const simb::MCParticle &particle,
         const std::vector<geo::BoxBoundedGeo> &active_volumes,
         const std::vector<std::vector<geo::BoxBoundedGeo>> &tpc_volumes,
-        const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE *>>> &id_to_ide_map,
-        const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
+        const caf::IDEMap &id_to_ide_map,
+        const caf::TrueHitMap &id_to_truehit_map,
         const cheat::BackTrackerService &backtracker,
         const cheat::ParticleInventoryService &inventory_service,
         const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                           caf::SRTrueParticle &srparticle) {
 
-    std::vector<std::pair<geo::WireID, const sim::IDE *>> empty;
-    const std::vector<std::pair<geo::WireID, const sim::IDE *>> &particle_ides = id_to_ide_map.count(particle.TrackId()) ? id_to_ide_map.at(particle.TrackId()) : empty;
-
-    std::vector<art::Ptr<recob::Hit>> emptyHits;
-    const std::vector<art::Ptr<recob::Hit>> &particle_hits = id_to_truehit_map.count(particle.TrackId()) ? id_to_truehit_map.at(particle.TrackId()) : emptyHits;
+    const caf::IDEMap::Range particle_ides = id_to_ide_map.Find(particle.TrackId());
+    const caf::TrueHitMap::Range particle_hits = id_to_truehit_map.Find(particle.TrackId());
 
     srparticle.length = 0.;
     srparticle.crosses_tpc = false;
@@ -729,7 +739,7 @@ namespace caf {
 
     // setup aa volumes too for length calc
     // Define the volume used for length calculation to be the cryostat volume in question
-    std::vector<geoalgo::AABox> aa_volumes;
+    std::vector<geoalgo::SlabBox> aa_volumes;
     if (entry_point >= 0) {
       const geo::BoxBoundedGeo &v = active_volumes.at(cryostat_index);
       aa_volumes.emplace_back(v.MinX(), v.MinY(), v.MinZ(), v.MaxX(), v.MaxY(), v.MaxZ());
@@ -742,6 +752,10 @@ namespace caf {
       // particle trajectory
       const simb::MCTrajectory &trajectory = particle.Trajectory();
       TVector3 pos = trajectory.Position(entry_point).Vect();
+      // steps are collected here, and their length in the volume computed
+      // in a single pass after the loop
+      geoalgo::SegmentArray steps;
+      steps.reserve(particle.NumberTrajectoryPoints() - entry_point);
       for (unsigned i = entry_point+1; i < particle.NumberTrajectoryPoints(); i++) {
         TVector3 this_point = trajectory.Position(i).Vect();
         // get the exit point
@@ -765,7 +779,7 @@ namespace caf {
         }
 
         // update length
-        srparticle.length += ContainedLength(this_point, pos, aa_volumes);
+        steps.push_back(this_point.X(), this_point.Y(), this_point.Z(), pos.X(), pos.Y(), pos.Z());
 
         if (!active_volumes.at(cryostat_index).ContainsPosition(this_point) && active_volumes.at(cryostat_index).ContainsPosition(pos)) {
           exit_point = i-1;
@@ -773,6 +787,7 @@ namespace caf {
 
         pos = trajectory.Position(i).Vect();
       }
+      srparticle.length = geoalgo::ContainedLength(steps, aa_volumes);
     }
     if (exit_point < 0 && entry_point >= 0) {
       exit_point = particle.NumberTrajectoryPoints() - 1;
@@ -835,6 +850,7 @@ namespace caf {
 
   void FillFakeReco(const std::vector<art::Ptr<simb::MCTruth>> &mctruths,
                     const std::vector<caf::SRTrueParticle> &srparticles,
+                    const caf::TrueParticleIndex &particle_index,
                     const std::vector<art::Ptr<sim::MCTrack>> &mctracks,
                     const std::vector<geo::BoxBoundedGeo> &volumes,
                     CLHEP::HepRandomEngine &rand,
@@ -844,7 +860,7 @@ namespace caf {
       bool do_fill = false;
       caf::SRFakeReco this_fakereco;
       do_fill = FRFillNumuCC(*mctruth, mctracks, volumes, rand, this_fakereco);
-      if(!do_fill) do_fill = FRFillNueCC(*mctruth, srparticles, volumes, rand, this_fakereco);
+      if(!do_fill) do_fill = FRFillNueCC(*mctruth, srparticles, particle_index, volumes, rand, this_fakereco);
 
       // TODO: others?
       // if (!do_fill) ...
@@ -871,21 +887,28 @@ namespace caf {
     return ret;
   }
 
-  std::map<int, std::vector<art::Ptr<recob::Hit>>> PrepTrueHits(const std::vector<art::Ptr<recob::Hit>> &allHits, 
+  caf::TrueHitMap PrepTrueHits(const std::vector<art::Ptr<recob::Hit>> &allHits, 
     const detinfo::DetectorClocksData &clockData, const cheat::BackTrackerService &backtracker) {
-    std::map<int, std::vector<art::Ptr<recob::Hit>>> ret;
-    for (const art::Ptr<recob::Hit> h: allHits) {
+    std::vector<std::pair<int, art::Ptr<recob::Hit>>> entries;
+    entries.reserve(allHits.size());
+    for (const art::Ptr<recob::Hit> &h: allHits) {
       for (int ID: backtracker.HitToTrackIds(clockData, *h)) {
-        ret[abs(ID)].push_back(h);
+        entries.emplace_back(abs(ID), h);
       }
     }
-    return ret;
+    return caf::TrueHitMap(std::move(entries));
   }
 
-  std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> PrepSimChannels(const std::vector<art::Ptr<sim::SimChannel>> &simchannels, const geo::WireReadoutGeom &wireReadout) {
-    std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> ret;
+  caf::IDEMap PrepSimChannels(const std::vector<art::Ptr<sim::SimChannel>> &simchannels, const geo::WireReadoutGeom &wireReadout) {
+    std::size_t nIDEs = 0;
+    for (const art::Ptr<sim::SimChannel> &sc : simchannels) {
+      for (const auto &item : sc->TDCIDEMap()) nIDEs += item.second.size();
+    }
+
+    std::vector<std::pair<int, std::pair<geo::WireID, const sim::IDE*>>> entries;
+    entries.reserve(nIDEs);
 
-    for (const art::Ptr<sim::SimChannel> sc : simchannels) {
+    for (const art::Ptr<sim::SimChannel> &sc : simchannels) {
       // Lookup the wire of this channel
       raw::ChannelID_t channel = sc->Channel();
       std::vector<geo::WireID> maybewire = wireReadout.ChannelToWire(channel);
@@ -894,12 +917,11 @@ namespace caf {
 
       for (const auto &item : sc->TDCIDEMap()) {
         for (const sim::IDE &ide: item.second) {
-          // indexing initializes empty vector
-          ret[abs(ide.trackID)].push_back({thisWire, &ide});
+          entries.push_back({abs(ide.trackID), {thisWire, &ide}});
         }
       }
     }
-    return ret;
+    return caf::IDEMap(std::move(entries));
   }
 
 } // end namespace
@@ -956,7 +978,7 @@ bool FRFillNumuCC(const simb::MCTruth &mctruth,
 
   if (cryo_index == -1) return false;
 
-  std::vector<geoalgo::AABox> aa_volumes;
+  std::vector<geoalgo::SlabBox> aa_volumes;
   const geo::BoxBoundedGeo &v = volumes.at(cryo_index);
   aa_volumes.emplace_back(v.MinX(), v.MinY(), v.MinZ(), v.MaxX(), v.MaxY(), v.MaxZ());
 
@@ -1074,6 +1096,7 @@ bool FRFillNumuCC(const simb::MCTruth &mctruth,
 
 bool FRFillNueCC(const simb::MCTruth &mctruth,
                   const std::vector<caf::SRTrueParticle> &srparticles,
+                  const caf::TrueParticleIndex &particle_index,
                   const std::vector<geo::BoxBoundedGeo> &volumes,
                   CLHEP::HepRandomEngine &rand,
                   caf::SRFakeReco &fakereco) {
@@ -1128,7 +1151,7 @@ bool FRFillNueCC(const simb::MCTruth &mctruth,
 
   if (cryo_index == -1) return false;
 
-  std::vector<geoalgo::AABox> aa_volumes;
+  std::vector<geoalgo::SlabBox> aa_volumes;
   const geo::BoxBoundedGeo &v = volumes.at(cryo_index);
   aa_volumes.emplace_back(v.MinX(), v.MinY(), v.MinZ(), v.MaxX(), v.MaxY(), v.MaxZ());
 
@@ -1144,12 +1167,10 @@ bool FRFillNueCC(const simb::MCTruth &mctruth,
                                                   nuVtx.Y() - particle.start.y,
                                                   nuVtx.Z() - particle.start.z);
     if((pdg == 11 || pdg == 22) && distance_from_vertex < 5) {
-      const auto parent = std::find_if(srparticles.begin(), srparticles.end(),
-        [&particle](const caf::SRTrueParticle& parent_candidate) -> bool {
-          return particle.parent == std::abs(parent_candidate.G4ID);
-        });
-      if((parent == srparticles.end()
-           || !(std::abs((*parent).pdg) == 11 || std::abs((*parent).pdg) == 22))
+      // The parent ID is that of the particle, whatever its sign
+      const int i_parent = particle_index.FindAbs(particle.parent);
+      if((i_parent < 0
+           || !(std::abs(srparticles[i_parent].pdg) == 11 || std::abs(srparticles[i_parent].pdg) == 22))
          && SmearLepton(particle, rand) > 0.1) {
         lepton_candidates.push_back(&particle);
       }
@@ -1296,199 +1317,34 @@ caf::Wall_t caf::GetWallCross(const geo::BoxBoundedGeo &volume, const TVector3 p
 //------------------------------------------
 
 caf::g4_process_ caf::GetG4ProcessID(const std::string &process_name) {
-#define MATCH_PROCESS(name) if (process_name == #name) {return caf::kG4 ## name;}
-#define MATCH_PROCESS_NAMED(strname, id) if (process_name == #strname) {return caf::kG4 ## id;}
-  MATCH_PROCESS(primary)
-  MATCH_PROCESS(CoupledTransportation)
-  MATCH_PROCESS(FastScintillation)
-  MATCH_PROCESS(Decay)
-  MATCH_PROCESS(anti_neutronInelastic)
-  MATCH_PROCESS(neutronInelastic)
-  MATCH_PROCESS(anti_protonInelastic)
-  MATCH_PROCESS(protonInelastic)
-  MATCH_PROCESS(hadInelastic)
-  MATCH_PROCESS_NAMED(kaon+Inelastic, kaonpInelastic)
-  MATCH_PROCESS_NAMED(kaon-Inelastic, kaonmInelastic)
-  MATCH_PROCESS_NAMED(kaon+Inelastic, kaonpInelastic)
-  MATCH_PROCESS_NAMED(kaon-Inelastic, kaonmInelastic)
-  MATCH_PROCESS_NAMED(sigma+Inelastic, sigmapInelastic)
-  MATCH_PROCESS_NAMED(sigma-Inelastic, sigmamInelastic)
-  MATCH_PROCESS_NAMED(pi+Inelastic, pipInelastic)
-  MATCH_PROCESS_NAMED(pi-Inelastic, pimInelastic)
-  MATCH_PROCESS_NAMED(xi+Inelastic, xipInelastic)
-  MATCH_PROCESS_NAMED(xi-Inelastic, ximInelastic)
-  MATCH_PROCESS(kaon0LInelastic)
-  MATCH_PROCESS(kaon0SInelastic)
-  MATCH_PROCESS(lambdaInelastic)
-  MATCH_PROCESS_NAMED(anti-lambdaInelastic, anti_lambdaInelastic)
-  MATCH_PROCESS(He3Inelastic)
-  MATCH_PROCESS(ionInelastic)
-  MATCH_PROCESS(xi0Inelastic)
-  MATCH_PROCESS(alphaInelastic)
-  MATCH_PROCESS(tInelastic)
-  MATCH_PROCESS(dInelastic)
-  MATCH_PROCESS(anti_neutronElastic)
-  MATCH_PROCESS(neutronElastic)
-  MATCH_PROCESS(anti_protonElastic)
-  MATCH_PROCESS(protonElastic)
-  MATCH_PROCESS(hadElastic)
-  MATCH_PROCESS_NAMED(kaon+Elastic, kaonpElastic)
-  MATCH_PROCESS_NAMED(kaon-Elastic, kaonmElastic)
-  MATCH_PROCESS_NAMED(pi+Elastic, pipElastic)
-  MATCH_PROCESS_NAMED(pi-Elastic, pimElastic)
-  MATCH_PROCESS(conv)
-  MATCH_PROCESS(phot)
-  MATCH_PROCESS(annihil)
-  MATCH_PROCESS(nCapture)
-  MATCH_PROCESS(nKiller)
-  MATCH_PROCESS(muMinusCaptureAtRest)
-  MATCH_PROCESS(muIoni)
-  MATCH_PROCESS(eBrem)
-  MATCH_PROCESS(CoulombScat)
-  MATCH_PROCESS(hBertiniCaptureAtRest)
-  MATCH_PROCESS(hFritiofCaptureAtRest)
-  MATCH_PROCESS(photonNuclear)
-  MATCH_PROCESS(muonNuclear)
-  MATCH_PROCESS(electronNuclear)
-  MATCH_PROCESS(positronNuclear)
-  MATCH_PROCESS(compt)
-  MATCH_PROCESS(eIoni)
-  MATCH_PROCESS(muBrems)
-  MATCH_PROCESS(hIoni)
-  MATCH_PROCESS(ionIoni)
-  MATCH_PROCESS(hBrems)
-  MATCH_PROCESS(muPairProd)
-  MATCH_PROCESS(hPairProd)
-  MATCH_PROCESS(LArVoxelReadoutScoringProcess)
-  MATCH_PROCESS(Transportation)
-  MATCH_PROCESS(msc)
-  MATCH_PROCESS(StepLimiter)
+  caf::g4_process_ id;
+  if (caf::LookupG4Process(process_name, id)) return id;
+
   std::cerr << "Error: Process name with no match (" << process_name << ")\n";
   assert(false);
   return caf::kG4UNKNOWN; // unreachable in debug mode
-#undef MATCH_PROCESS
-#undef MATCH_PROCESS_NAMED
-
 }//GetG4ProcessID
 //-------------------------------------------
 
 float ContainedLength(const TVector3 &v0, const TVector3 &v1,
-                       const std::vector<geoalgo::AABox> &boxes) {
-  static const geoalgo::GeoAlgo algo;
-
-  // if points are the same, return 0
-  if ((v0 - v1).Mag() < 1e-6) return 0;
-
-  // construct individual points
-  geoalgo::Point_t p0(v0);
-  geoalgo::Point_t p1(v1);
-
-  // construct line segment
-  geoalgo::LineSegment line(p0, p1);
-
-  double length = 0;
+                       const std::vector<geoalgo::SlabBox> &boxes) {
+  geoalgo::SegmentArray segment;
+  segment.push_back(v0.X(), v0.Y(), v0.Z(), v1.X(), v1.Y(), v1.Z());
 
   // total contained length is sum of lengths in all boxes
   // assuming they are non-overlapping
-  for (auto const &box: boxes) {
-    int n_contained = box.Contain(p0) + box.Contain(p1);
-    // both points contained -- length is total length (also can break out of loop)
-    if (n_contained == 2) {
-      length = (v1 - v0).Mag();
-      break;
-    }
-    // one contained -- have to find intersection point (which must exist)
-    if (n_contained == 1) {
-      auto intersections = algo.Intersection(line, box);
-      // Because of floating point errors, it can sometimes happen
-      // that there is 1 contained point but no "Intersections"
-      // if one of the points is right on the edge
-      if (intersections.size() == 0) {
-        // determine which point is on the edge
-        double tol = 1e-5;
-        bool p0_edge = algo.SqDist(p0, box) < tol;
-        bool p1_edge = algo.SqDist(p1, box) < tol;
-        assert(p0_edge || p1_edge);
-        // contained one is on edge -- can treat both as not contained
-        //
-        // In this case, no length
-        if ((p0_edge && box.Contain(p0)) || (box.Contain(p1) && p1_edge))
-          continue;
-        // un-contaned one is on edge -- treat both as contained
-        else if ((p0_edge && box.Contain(p1)) || (box.Contain(p0) && p1_edge)) {
-    length = (v1 - v0).Mag();
-    break;
-        }
-        else {
-          assert(false); // bad
-        }
-      }
-      // floating point errors can also falsely cause 2 intersection points
-      //
-      // in this case, one of the intersections must be very close to the
-      // "contained" point, so the total contained length will be about
-      // the same as the distance between the two intersection points
-      else if (intersections.size() == 2) {
-        length += (intersections.at(0).ToTLorentzVector().Vect() - intersections.at(1).ToTLorentzVector().Vect()).Mag();
-        continue;
-      }
-      // "Correct"/ideal case -- 1 intersection point
-      else if (intersections.size() == 1) {
-        // get TVector at intersection point
-        TVector3 int_tv(intersections.at(0).ToTLorentzVector().Vect());
-        length += ( box.Contain(p0) ? (v0 - int_tv).Mag() : (v1 - int_tv).Mag() );
-      }
-      else assert(false); // bad
-    }
-    // none contained -- either must have zero or two intersections
-    if (n_contained == 0) {
-      auto intersections = algo.Intersection(line, box);
-      if (!(intersections.size() == 0 || intersections.size() == 2)) {
-        // more floating point error fixes...
-        //
-        // figure out which points are near the edge
-        double tol = 1e-5;
-        bool p0_edge = algo.SqDist(p0, box) < tol;
-        bool p1_edge = algo.SqDist(p1, box) < tol;
-        // and which points are near the intersection
-        TVector3 vint = intersections.at(0).ToTLorentzVector().Vect();
-
-        bool p0_int = (v0 - vint).Mag() < tol;
-        bool p1_int = (v1 - vint).Mag() < tol;
-        // exactly one of them should produce the intersection
-        assert((p0_int && p0_edge) != (p1_int && p1_edge));
-        // void variables when assert-ions are turned off
-        (void) p0_int; (void) p1_int;
-
-        // both close to edge -- full length is contained
-        if (p0_edge && p1_edge) {
-          length += (v0 - v1).Mag();
-        }
-        // otherwise -- one of them is not on an edge, no length is contained
-        else {}
-      }
-      // assert(intersections.size() == 0 || intersections.size() == 2);
-      else if (intersections.size() == 2) {
-        TVector3 start(intersections.at(0).ToTLorentzVector().Vect());
-        TVector3 end(intersections.at(1).ToTLorentzVector().Vect());
-        length += (start - end).Mag();
-      }
-    }
-  }
-
-  return length;
+  return geoalgo::ContainedLength(segment, boxes);
 }//ContainedLength
 
 //------------------------------------------------
-caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const std::vector<caf::SRTrueParticle> &particles, const std::vector<art::Ptr<recob::Hit>> &hits,
+caf::SRTrackTruth MatchTrack2Truth(const caf::HitTruthTable &hit_truth, const std::vector<caf::SRTrueParticle> &particles,
+                                   const caf::TrueParticleIndex &particle_index, const std::vector<art::Ptr<recob::Hit>> &hits,
 				   const std::map<int, caf::HitsEnergy> &all_hits_map) {
 
-  art::ServiceHandle<cheat::BackTrackerService> bt_serv;
-
   // this id is the same as the mcparticle ID as long as we got it from geant4
-  std::vector<std::pair<int, float>> matches = CAFRecoUtils::AllTrueParticleIDEnergyMatches(clockData, hits, true);
-  float total_energy = CAFRecoUtils::TotalHitEnergy(clockData, hits);
-  std::map<int, caf::HitsEnergy> track_hits_map = caf::SetupIDHitEnergyMap(hits, clockData, *bt_serv.get());
+  std::vector<std::pair<int, float>> matches = hit_truth.AllTrueParticleIDEnergyMatches(hits);
+  float total_energy = hit_truth.TotalHitEnergy(hits);
+  std::map<int, caf::HitsEnergy> track_hits_map = hit_truth.IDHitEnergyMap(hits);
 
   caf::SRTrackTruth ret;
 
@@ -1521,12 +1377,10 @@ caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData,
   bool found_bestmatch = false;
   if (ret.matches.size()) {
     ret.bestmatch = ret.matches.at(0);
-    for (unsigned i_part = 0; i_part < particles.size(); i_part++) {
-      if (particles[i_part].G4ID == ret.bestmatch.G4ID) {
-        ret.p = particles[i_part];
-        found_bestmatch = true;
-        break;
-      }
+    const int i_part = particle_index.Find(ret.bestmatch.G4ID);
+    if (i_part >= 0) {
+      ret.p = particles[i_part];
+      found_bestmatch = true;
     }
   }
 
@@ -1572,9 +1426,9 @@ caf::SRTruthMatch MatchSlice2Truth(const std::vector<art::Ptr<recob::Hit>> &hits
                                    const std::vector<art::Ptr<simb::MCTruth>> &truths,
                                    const caf::SRTruthBranch &srmc,
                                    const cheat::ParticleInventoryService &inventory_service,
-                                   const detinfo::DetectorClocksData &clockData) {
+                                   const caf::HitTruthTable &hit_truth) {
   caf::SRTruthMatch ret;
-  float total_energy = CAFRecoUtils::TotalHitEnergy(clockData, hits);
+  float total_energy = hit_truth.TotalHitEnergy(hits);
   // speed optimization: if there are no truths, all the matching energy must be cosmic
   if (truths.empty()) {
     ret.visEinslc = total_energy / 1000. /* MeV -> GeV */;
@@ -1585,7 +1439,7 @@ caf::SRTruthMatch MatchSlice2Truth(const std::vector<art::Ptr<recob::Hit>> &hits
     ret.index = -1;
     return ret;
   }
-  std::vector<std::pair<int, float>> matches = CAFRecoUtils::AllTrueParticleIDEnergyMatches(clockData, hits, true);
+  std::vector<std::pair<int, float>> matches = hit_truth.AllTrueParticleIDEnergyMatches(hits);
   std::vector<float> matching_energy(truths.size(), 0.);
   for (auto const &pair: matches) {
     art::Ptr<simb::MCTruth> truth;
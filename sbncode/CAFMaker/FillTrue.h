@@ -33,13 +33,12 @@
 #include "sbnanaobj/StandardRecord/StandardRecord.h"
 #include "sbnanaobj/StandardRecord/SRMeVPrtl.h"
 
+#include "sbncode/CAFMaker/HitTruthTable.h"
+#include "sbncode/CAFMaker/TrackIDTable.h"
+#include "sbncode/CAFMaker/TrueParticleIndex.h"
+
 namespace caf
 {
-  struct HitsEnergy {
-    int nHits;
-    float totE;
-  };
-
   // Helpers
   caf::Wall_t GetWallCross( const geo::BoxBoundedGeo &volume,
         const TVector3 p0,
@@ -55,7 +54,7 @@ namespace caf
                       const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                       const caf::SRTruthBranch &srmc,
                       const cheat::ParticleInventoryService &inventory_service,
-                      const detinfo::DetectorClocksData &clockData,
+                      const caf::HitTruthTable &hit_truth,
                       caf::SRSlice &srslice,
                       bool allowEmpty = false);
 
@@ -63,9 +62,10 @@ namespace caf
                          const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
                          const caf::SRTruthBranch &srmc,
                          const cheat::ParticleInventoryService &inventory_service,
-                         const detinfo::DetectorClocksData &clockData,
+                         const caf::HitTruthTable &hit_truth,
                          caf::SRSlice &srslice,
                          const std::vector<caf::SRTrueParticle> &srparticles,
+                         const caf::TrueParticleIndex &particle_index,
                          const std::vector<art::Ptr<sim::MCTrack>> &mctracks,
                          const std::vector<geo::BoxBoundedGeo> &volumes,
                          CLHEP::HepRandomEngine &rand);
@@ -73,8 +73,8 @@ namespace caf
   void FillTrueG4Particle(const simb::MCParticle &particle,
         const std::vector<geo::BoxBoundedGeo> &active_volumes,
         const std::vector<std::vector<geo::BoxBoundedGeo>> &tpc_volumes,
-        const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE *>>> &id_to_ide_map,
-        const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
+        const caf::IDEMap &id_to_ide_map,
+        const caf::TrueHitMap &id_to_truehit_map,
         const cheat::BackTrackerService &backtracker,
         const cheat::ParticleInventoryService &inventory_service,
         const std::vector<art::Ptr<simb::MCTruth>> &neutrinos,
@@ -88,23 +88,29 @@ namespace caf
                         const simb::MCFlux &mcflux,
                         const simb::GTruth& gtruth,
                         const std::vector<caf::SRTrueParticle> &srparticles,
-                        const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
+                        const caf::TrueHitMap &id_to_truehit_map,
                         caf::SRTrueInteraction &srneutrino, size_t i,
                         const std::vector<geo::BoxBoundedGeo> &active_volumes);
 
   void FillEventWeight(const sbn::evwgh::EventWeightMap& wgtmap,
                        caf::SRTrueInteraction& srint,
-                       const std::map<std::string, unsigned int>& weightPSetIndex);
+                       const std::map<std::string, unsigned int>& weightPSetIndex,
+                       bool dropAllOnes = false,
+                       bool quantize = false);
 
   void FillTrackTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                       const std::map<int, caf::HitsEnergy> &id_hits_map,
                       const std::vector<caf::SRTrueParticle> &particles,
-                      const detinfo::DetectorClocksData &clockData,
+                      const caf::TrueParticleIndex &particle_index,
+                      const caf::HitTruthTable &hit_truth,
                       caf::SRTrack& srtrack,
                       bool allowEmpty = false);
 
-  void FillTrackCaloTruth(const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> &id_to_ide_map,
+  // mc_particles must be in the same order as the SRTrueParticles that
+  // particle_index was built from
+  void FillTrackCaloTruth(const caf::IDEMap &id_to_ide_map,
                           const std::vector<simb::MCParticle> &mc_particles,
+                          const caf::TrueParticleIndex &particle_index,
                           const geo::GeometryCore & geometry,
                           const geo::WireReadoutGeom& wireReadout,
                           const detinfo::DetectorClocksData &clockData,
@@ -115,26 +121,29 @@ namespace caf
   void FillStubTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                      const std::map<int, caf::HitsEnergy> &id_hits_map,
                      const std::vector<caf::SRTrueParticle> &particles,
-                     const detinfo::DetectorClocksData &clockData,
+                     const caf::TrueParticleIndex &particle_index,
+                     const caf::HitTruthTable &hit_truth,
                      caf::SRStub& srstub,
                      bool allowEmpty = false);
 
   void FillShowerTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                        const std::map<int, caf::HitsEnergy> &id_hits_map,
                        const std::vector<caf::SRTrueParticle> &particles,
-                       const detinfo::DetectorClocksData &clockData,
+                       const caf::TrueParticleIndex &particle_index,
+                       const caf::HitTruthTable &hit_truth,
                        caf::SRShower& srshower,
                        bool allowEmpty = false);
 
   void FillFakeReco(const std::vector<art::Ptr<simb::MCTruth>> &mctruths,
                     const std::vector<caf::SRTrueParticle> &srparticles,
+                    const caf::TrueParticleIndex &particle_index,
                     const std::vector<art::Ptr<sim::MCTrack>> &mctracks,
                     const std::vector<geo::BoxBoundedGeo> &volumes,
                     CLHEP::HepRandomEngine &rand,
                     std::vector<caf::SRFakeReco> &srfakereco);
 
-  std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> PrepSimChannels(const std::vector<art::Ptr<sim::SimChannel>> &simchannels, const geo::WireReadoutGeom &wireReadout);
-  std::map<int, std::vector<art::Ptr<recob::Hit>>> PrepTrueHits(const std::vector<art::Ptr<recob::Hit>> &allHits,
+  caf::IDEMap PrepSimChannels(const std::vector<art::Ptr<sim::SimChannel>> &simchannels, const geo::WireReadoutGeom &wireReadout);
+  caf::TrueHitMap PrepTrueHits(const std::vector<art::Ptr<recob::Hit>> &allHits,
     const detinfo::DetectorClocksData &clockData, const cheat::BackTrackerService &backtracker);
   std::map<int, caf::HitsEnergy> SetupIDHitEnergyMap(const std::vector<art::Ptr<recob::Hit>> &allHits, const detinfo::DetectorClocksData &clockData,
     const cheat::BackTrackerService &backtracker);
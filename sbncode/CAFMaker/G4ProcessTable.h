@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////
+// \file    G4ProcessTable.h
+// \brief   Geant4 process name -> caf::g4_process_ lookup
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_G4PROCESSTABLE_H
+#define CAF_G4PROCESSTABLE_H
+
+#include "sbnanaobj/StandardRecord/SREnums.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace caf
+{
+  namespace detail
+  {
+    using G4ProcessEntry = std::pair<std::string_view, caf::g4_process_>;
+
+    /// Every process name caf::GetG4ProcessID knows, sorted by name
+    constexpr std::array<G4ProcessEntry, 63> kG4ProcessTable {{
+      {"CoulombScat",                   caf::kG4CoulombScat},
+      {"CoupledTransportation",         caf::kG4CoupledTransportation},
+      {"Decay",                         caf::kG4Decay},
+      {"FastScintillation",             caf::kG4FastScintillation},
+      {"He3Inelastic",                  caf::kG4He3Inelastic},
+      {"LArVoxelReadoutScoringProcess", caf::kG4LArVoxelReadoutScoringProcess},
+      {"StepLimiter",                   caf::kG4StepLimiter},
+      {"Transportation",                caf::kG4Transportation},
+      {"alphaInelastic",                caf::kG4alphaInelastic},
+      {"annihil",                       caf::kG4annihil},
+      {"anti-lambdaInelastic",          caf::kG4anti_lambdaInelastic},
+      {"anti_neutronElastic",           caf::kG4anti_neutronElastic},
+      {"anti_neutronInelastic",         caf::kG4anti_neutronInelastic},
+      {"anti_protonElastic",            caf::kG4anti_protonElastic},
+      {"anti_protonInelastic",          caf::kG4anti_protonInelastic},
+      {"compt",                         caf::kG4compt},
+      {"conv",                          caf::kG4conv},
+      {"dInelastic",                    caf::kG4dInelastic},
+      {"eBrem",                         caf::kG4eBrem},
+      {"eIoni",                         caf::kG4eIoni},
+      {"electronNuclear",               caf::kG4electronNuclear},
+      {"hBertiniCaptureAtRest",         caf::kG4hBertiniCaptureAtRest},
+      {"hBrems",                        caf::kG4hBrems},
+      {"hFritiofCaptureAtRest",         caf::kG4hFritiofCaptureAtRest},
+      {"hIoni",                         caf::kG4hIoni},
+      {"hPairProd",                     caf::kG4hPairProd},
+      {"hadElastic",                    caf::kG4hadElastic},
+      {"hadInelastic",                  caf::kG4hadInelastic},
+      {"ionInelastic",                  caf::kG4ionInelastic},
+      {"ionIoni",                       caf::kG4ionIoni},
+      {"kaon+Elastic",                  caf::kG4kaonpElastic},
+      {"kaon+Inelastic",                caf::kG4kaonpInelastic},
+      {"kaon-Elastic",                  caf::kG4kaonmElastic},
+      {"kaon-Inelastic",                caf::kG4kaonmInelastic},
+      {"kaon0LInelastic",               caf::kG4kaon0LInelastic},
+      {"kaon0SInelastic",               caf::kG4kaon0SInelastic},
+      {"lambdaInelastic",               caf::kG4lambdaInelastic},
+      {"msc",                           caf::kG4msc},
+      {"muBrems",                       caf::kG4muBrems},
+      {"muIoni",                        caf::kG4muIoni},
+      {"muMinusCaptureAtRest",          caf::kG4muMinusCaptureAtRest},
+      {"muPairProd",                    caf::kG4muPairProd},
+      {"muonNuclear",                   caf::kG4muonNuclear},
+      {"nCapture",                      caf::kG4nCapture},
+      {"nKiller",                       caf::kG4nKiller},
+      {"neutronElastic",                caf::kG4neutronElastic},
+      {"neutronInelastic",              caf::kG4neutronInelastic},
+      {"phot",                          caf::kG4phot},
+      {"photonNuclear",                 caf::kG4photonNuclear},
+      {"pi+Elastic",                    caf::kG4pipElastic},
+      {"pi+Inelastic",                  caf::kG4pipInelastic},
+      {"pi-Elastic",                    caf::kG4pimElastic},
+      {"pi-Inelastic",                  caf::kG4pimInelastic},
+      {"positronNuclear",               caf::kG4positronNuclear},
+      {"primary",                       caf::kG4primary},
+      {"protonElastic",                 caf::kG4protonElastic},
+      {"protonInelastic",               caf::kG4protonInelastic},
+      {"sigma+Inelastic",               caf::kG4sigmapInelastic},
+      {"sigma-Inelastic",               caf::kG4sigmamInelastic},
+      {"tInelastic",                    caf::kG4tInelastic},
+      {"xi+Inelastic",                  caf::kG4xipInelastic},
+      {"xi-Inelastic",                  caf::kG4ximInelastic},
+      {"xi0Inelastic",                  caf::kG4xi0Inelastic}
+    }};
+
+    constexpr bool IsSortedByName(const std::array<G4ProcessEntry, kG4ProcessTable.size()> &table)
+    {
+      for (std::size_t i = 1; i < table.size(); i++) {
+        if (!(table[i-1].first < table[i].first)) return false;
+      }
+      return true;
+    }
+
+    static_assert(IsSortedByName(kG4ProcessTable),
+                  "kG4ProcessTable must be sorted by name, without duplicates");
+  }
+
+  /// \brief Find the ID of a Geant4 process name
+  ///
+  /// Consecutive particles mostly share their processes (primary,
+  /// CoupledTransportation, ...), so the last few matches of each thread are
+  /// checked before the binary search of the table.
+  ///
+  /// \return false if the name is not in the table
+  inline bool LookupG4Process(std::string_view process_name, caf::g4_process_ &id)
+  {
+    using detail::G4ProcessEntry;
+    using detail::kG4ProcessTable;
+
+    thread_local std::array<const G4ProcessEntry*, 4> recent {};
+    for (const G4ProcessEntry *e: recent) {
+      if (e && e->first == process_name) {
+        id = e->second;
+        return true;
+      }
+    }
+
+    auto it = std::lower_bound(kG4ProcessTable.begin(), kG4ProcessTable.end(), process_name,
+                               [](const G4ProcessEntry &e, std::string_view name) { return e.first < name; });
+    if (it == kG4ProcessTable.end() || it->first != process_name) return false;
+
+    std::rotate(recent.begin(), recent.end() - 1, recent.end());
+    recent[0] = &*it;
+    id = it->second;
+    return true;
+  }
+}
+
+#endif
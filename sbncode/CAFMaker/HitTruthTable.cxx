@@ -0,0 +1,154 @@
+#include "sbncode/CAFMaker/HitTruthTable.h"
+
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "larsim/Utils/TruthMatchUtils.h"
+
+#include "RecoUtils/RecoUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+  int CachedShowerPrimary(int g4ID, std::map<int, int> &primaries)
+  {
+    auto it = primaries.find(g4ID);
+    if (it == primaries.end()) {
+      it = primaries.emplace(g4ID, CAFRecoUtils::GetShowerPrimary(g4ID)).first;
+    }
+    return it->second;
+  }
+}
+
+namespace caf
+{
+  //......................................................................
+  HitTruthTable::HitTruthTable(const std::vector<art::Ptr<recob::Hit>> &allHits,
+                               const detinfo::DetectorClocksData &clockData,
+                               const cheat::BackTrackerService &backtracker)
+    : fClockData(&clockData)
+    , fHits(allHits)
+  {
+    // Size the per-product tables up front so the lookups are by index
+    std::map<art::ProductID, std::size_t> maxKey;
+    for (const art::Ptr<recob::Hit> &h: allHits) {
+      std::size_t &n = maxKey[h.id()];
+      n = std::max(n, h.key() + 1);
+    }
+    for (const auto &pair: maxKey) fEntries[pair.first].resize(pair.second);
+
+    // GetShowerPrimary walks up the particle list, so only do it once per ID
+    std::map<int, int> primaries;
+
+    for (const art::Ptr<recob::Hit> &h: allHits) {
+      HitEntry &entry = fEntries[h.id()][h.key()];
+      if (entry.filled) continue;
+
+      entry.filled = true;
+      entry.begin = fContributions.size();
+      entry.trueID = Backtrack(h, backtracker, primaries, fContributions);
+      entry.end = fContributions.size();
+    }
+  }
+
+  //......................................................................
+  int HitTruthTable::Backtrack(const art::Ptr<recob::Hit> &hit,
+                               const cheat::BackTrackerService &backtracker,
+                               std::map<int, int> &primaries,
+                               std::vector<Contribution> &contribs) const
+  {
+    for (const sim::TrackIDE &ide: backtracker.HitToTrackIDEs(*fClockData, hit)) {
+      contribs.push_back({ide.trackID,
+                          CachedShowerPrimary(ide.trackID, primaries),
+                          CachedShowerPrimary(std::abs(ide.trackID), primaries),
+                          ide.energy});
+    }
+
+    return CachedShowerPrimary(TruthMatchUtils::TrueParticleID(*fClockData, hit, true), primaries);
+  }
+
+  //......................................................................
+  const HitTruthTable::HitEntry* HitTruthTable::Find(const art::Ptr<recob::Hit> &hit) const
+  {
+    auto it = fEntries.find(hit.id());
+    if (it == fEntries.end() || hit.key() >= it->second.size()) return nullptr;
+
+    const HitEntry &entry = it->second[hit.key()];
+    return entry.filled ? &entry : nullptr;
+  }
+
+  //......................................................................
+  template <class F>
+  void HitTruthTable::ForEachHit(const std::vector<art::Ptr<recob::Hit>> &hits, F f) const
+  {
+    std::vector<Contribution> scratch;
+    std::map<int, int> primaries;
+
+    for (const art::Ptr<recob::Hit> &h: hits) {
+      if (const HitEntry *entry = Find(h)) {
+        f(entry->trueID, fContributions.data() + entry->begin, fContributions.data() + entry->end);
+        continue;
+      }
+
+      // Not in the table: backtrack it now
+      art::ServiceHandle<cheat::BackTrackerService> bt_serv;
+      scratch.clear();
+      const int trueID = Backtrack(h, *bt_serv, primaries, scratch);
+      f(trueID, scratch.data(), scratch.data() + scratch.size());
+    }
+  }
+
+  //......................................................................
+  std::vector<std::pair<int, float>> HitTruthTable::AllTrueParticleIDEnergyMatches(const std::vector<art::Ptr<recob::Hit>> &hits) const
+  {
+    std::map<int, float> trackIDToEDepMap;
+    ForEachHit(hits, [&](int, const Contribution *begin, const Contribution *end) {
+        for (const Contribution *c = begin; c != end; ++c) {
+          trackIDToEDepMap[c->absPrimaryID] += c->energy;
+        }
+      });
+
+    return std::vector<std::pair<int, float>>(trackIDToEDepMap.begin(), trackIDToEDepMap.end());
+  }
+
+  //......................................................................
+  float HitTruthTable::TotalHitEnergy(const std::vector<art::Ptr<recob::Hit>> &hits) const
+  {
+    float ret = 0.;
+    ForEachHit(hits, [&](int, const Contribution *begin, const Contribution *end) {
+        for (const Contribution *c = begin; c != end; ++c) ret += c->energy;
+      });
+
+    return ret;
+  }
+
+  //......................................................................
+  std::map<int, caf::HitsEnergy> HitTruthTable::IDHitEnergyMap(const std::vector<art::Ptr<recob::Hit>> &hits) const
+  {
+    std::map<int, caf::HitsEnergy> ret;
+    ForEachHit(hits, [&](int trueID, const Contribution *begin, const Contribution *end) {
+        ++ret[trueID].nHits;
+        for (const Contribution *c = begin; c != end; ++c) {
+          ret[c->primaryID].totE += c->energy;
+        }
+      });
+
+    return ret;
+  }
+
+  //......................................................................
+  caf::TrueHitMap HitTruthTable::TrueHits() const
+  {
+    std::vector<std::pair<int, art::Ptr<recob::Hit>>> entries;
+    entries.reserve(fContributions.size());
+    for (const art::Ptr<recob::Hit> &h: fHits) {
+      const HitEntry *entry = Find(h);
+      for (std::size_t i = entry->begin; i < entry->end; i++) {
+        entries.emplace_back(std::abs(fContributions[i].trackID), h);
+      }
+    }
+
+    return caf::TrueHitMap(std::move(entries));
+  }
+
+} // end namespace caf
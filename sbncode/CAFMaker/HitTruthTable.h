@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////
+// \file    HitTruthTable.h
+// \brief   Per-event table of backtracked hits shared by the CAF truth matchers
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_HITTRUTHTABLE_H
+#define CAF_HITTRUTHTABLE_H
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "larsim/MCCheater/BackTrackerService.h"
+
+#include "sbncode/CAFMaker/TrackIDTable.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace caf
+{
+  struct HitsEnergy {
+    int nHits;
+    float totE;
+  };
+
+  /// \brief Backtracking information of every reconstructed hit in an event
+  ///
+  /// The BackTrackerService is queried once per hit when the table is built,
+  /// and the (track ID, energy) contributions of each hit are stored flat,
+  /// together with their shower primaries. The truth matchers then run over
+  /// the table instead of re-backtracking the same hits for every slice,
+  /// track, shower and stub. The results are identical to the corresponding
+  /// CAFRecoUtils / FillTrue functions, including the order of the sums.
+  ///
+  /// Hits that were not in the table when it was built are backtracked on
+  /// the fly, so the table can be used with any hit collection.
+  class HitTruthTable
+  {
+  public:
+    HitTruthTable() = default;
+
+    HitTruthTable(const std::vector<art::Ptr<recob::Hit>> &allHits,
+                  const detinfo::DetectorClocksData &clockData,
+                  const cheat::BackTrackerService &backtracker);
+
+    /// Same as CAFRecoUtils::AllTrueParticleIDEnergyMatches(clockData, hits, true)
+    std::vector<std::pair<int, float>> AllTrueParticleIDEnergyMatches(const std::vector<art::Ptr<recob::Hit>> &hits) const;
+
+    /// Same as CAFRecoUtils::TotalHitEnergy(clockData, hits)
+    float TotalHitEnergy(const std::vector<art::Ptr<recob::Hit>> &hits) const;
+
+    /// Same as caf::SetupIDHitEnergyMap(hits, clockData, backtracker)
+    std::map<int, caf::HitsEnergy> IDHitEnergyMap(const std::vector<art::Ptr<recob::Hit>> &hits) const;
+
+    /// Same as caf::PrepTrueHits over all the hits the table was built from
+    caf::TrueHitMap TrueHits() const;
+
+  private:
+    struct Contribution {
+      int trackID;      ///< As returned by the BackTracker
+      int primaryID;    ///< Shower primary of trackID
+      int absPrimaryID; ///< Shower primary of |trackID|
+      float energy;
+    };
+
+    struct HitEntry {
+      bool filled = false;
+      int trueID = 0; ///< Shower primary of the rolled-up TrueParticleID
+      std::size_t begin = 0, end = 0; ///< Range in fContributions
+    };
+
+    /// Backtrack \a hit, appending its contributions to \a contribs
+    int Backtrack(const art::Ptr<recob::Hit> &hit,
+                  const cheat::BackTrackerService &backtracker,
+                  std::map<int, int> &primaries,
+                  std::vector<Contribution> &contribs) const;
+
+    /// Table entry of \a hit, or nullptr if it was not in the table
+    const HitEntry* Find(const art::Ptr<recob::Hit> &hit) const;
+
+    /// Call f(trueID, begin, end) for each hit, backtracking missing ones
+    template <class F>
+    void ForEachHit(const std::vector<art::Ptr<recob::Hit>> &hits, F f) const;
+
+    const detinfo::DetectorClocksData *fClockData = nullptr;
+    std::vector<art::Ptr<recob::Hit>> fHits;
+    std::map<art::ProductID, std::vector<HitEntry>> fEntries; ///< Indexed by hit key
+    std::vector<Contribution> fContributions;
+  };
+
+} // end namespace caf
+
+#endif
@@ -0,0 +1,71 @@
+//////////////////////////////////////////////////////////////////////
+// \file    KeyRangeIndex.h
+// \brief   Sorted (product, key) -> positions table behind caf::AssnIndex
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_KEYRANGEINDEX_H
+#define CAF_KEYRANGEINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace caf
+{
+  /// \brief Positions of the items of a collection, grouped by (id, key)
+  ///
+  /// Independent of art, so that the association lookups of CAFMaker can be
+  /// benchmarked outside of it (see bin/assn_cache_bench.cc). \a Id only
+  /// needs operator< and operator==, as art::ProductID has.
+  template <class Id>
+  class KeyRangeIndex
+  {
+  public:
+    struct Entry {
+      Id id;
+      std::size_t key;
+      std::size_t index; ///< Position of the item in the indexed collection
+    };
+
+    using const_iterator = typename std::vector<Entry>::const_iterator;
+
+    void Reserve(std::size_t n) { fEntries.reserve(n); }
+
+    /// Add the item at position \a index of the collection; call Sort() after
+    void Add(const Id& id, std::size_t key, std::size_t index)
+    {
+      fEntries.push_back({id, key, index});
+    }
+
+    /// Stable, so that the items of one (id, key) keep their original order.
+    /// Producers mostly write associations in the order of their left
+    /// objects, which then need no sorting.
+    void Sort()
+    {
+      auto less = [](const Entry& a, const Entry& b) {
+        return a.id < b.id || (a.id == b.id && a.key < b.key);
+      };
+      if (!std::is_sorted(fEntries.begin(), fEntries.end(), less)) {
+        std::stable_sort(fEntries.begin(), fEntries.end(), less);
+      }
+    }
+
+    /// The entries of (id, key), in the order they were added
+    std::pair<const_iterator, const_iterator> Range(const Id& id, std::size_t key) const
+    {
+      auto it = std::lower_bound(fEntries.begin(), fEntries.end(), std::make_pair(id, key),
+                                 [](const Entry& e, const std::pair<Id, std::size_t>& k) {
+                                   return e.id < k.first || (e.id == k.first && e.key < k.second);
+                                 });
+      auto end = it;
+      while (end != fEntries.end() && end->id == id && end->key == key) ++end;
+      return {it, end};
+    }
+
+  private:
+    std::vector<Entry> fEntries;
+  };
+}
+
+#endif
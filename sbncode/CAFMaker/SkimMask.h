@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////
+// \file    SkimMask.h
+// \brief   Which StandardRecord sub-records a skim CAF keeps
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_SKIMMASK_H
+#define CAF_SKIMMASK_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace caf
+{
+  /// \brief Include/exclude lists of StandardRecord sub-records
+  ///
+  /// Names are the paths of the sub-records in the record, without the
+  /// leading "rec." (e.g. "crt_hits", "slc.reco.hit"). Only the entries of
+  /// KnownBranches() can be dropped; everything else, the header in
+  /// particular, is always kept. A sub-record is kept if the include list is
+  /// empty or names it, one of its parents or one of its children, and the
+  /// exclude list names neither it nor one of its parents.
+  ///
+  /// CAFMaker never fills the dropped sub-records, so they are written as
+  /// empty collections and the file layout is the same as the full CAF.
+  class SkimMask
+  {
+  public:
+    SkimMask() = default;
+
+    SkimMask(const std::vector<std::string> &include,
+             const std::vector<std::string> &exclude)
+    {
+      for (const std::string &name: KnownBranches()) {
+        bool keep = include.empty();
+        for (const std::string &inc: include) {
+          if (Contains(inc, name) || Contains(name, inc)) keep = true;
+        }
+        for (const std::string &exc: exclude) {
+          if (Contains(exc, name)) keep = false;
+        }
+        if (!keep) fDropped.push_back(name);
+      }
+    }
+
+    /// The sub-records that a skim may drop
+    static const std::vector<std::string>& KnownBranches()
+    {
+      static const std::vector<std::string> known = {
+        "mc", "fake_reco", "true_particles",
+        "crt_hits", "crt_tracks", "crt_spacepoints", "sbnd_crt_tracks", "crtpmt_matches",
+        "opflashes",
+        "reco.hit", "reco.stub",
+        "slc", "slc.reco.hit", "slc.reco.stub", "slc.reco.pfp.trk.calo"
+      };
+      return known;
+    }
+
+    static bool IsKnown(const std::string &name)
+    {
+      const std::vector<std::string> &known = KnownBranches();
+      return std::find(known.begin(), known.end(), name) != known.end();
+    }
+
+    bool Keep(const std::string &name) const
+    {
+      return std::find(fDropped.begin(), fDropped.end(), name) == fDropped.end();
+    }
+
+    bool IsSkim() const { return !fDropped.empty(); }
+
+    const std::vector<std::string>& Dropped() const { return fDropped; }
+
+  private:
+    /// Is \a child the sub-record \a parent itself or inside it?
+    static bool Contains(const std::string &parent, const std::string &child)
+    {
+      return child == parent ||
+        (child.size() > parent.size() && child.compare(0, parent.size(), parent) == 0 && child[parent.size()] == '.');
+    }
+
+    std::vector<std::string> fDropped;
+  };
+
+} // end namespace caf
+
+#endif
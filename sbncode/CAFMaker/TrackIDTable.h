@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////
+// \file    TrackIDTable.h
+// \brief   Flat G4 track ID -> list lookup used for the truth preparation
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_TRACKIDTABLE_H
+#define CAF_TRACKIDTABLE_H
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/Simulation/SimChannel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace caf
+{
+  /// \brief Values grouped by G4 track ID, stored in compressed sparse row
+  /// form
+  ///
+  /// Replaces a std::map<int, std::vector<T>>: the IDs are kept sorted in one
+  /// vector, the values of all of them back to back in another, and offsets
+  /// mark where each ID's values start. Building it is one stable sort
+  /// instead of a node and a vector allocation per ID, and a lookup is a
+  /// binary search over contiguous ints. The values of each ID stay in the
+  /// order they were added, as with push_back into the map.
+  template <class T>
+  class TrackIDTable
+  {
+  public:
+    /// Contiguous values of one ID
+    class Range
+    {
+    public:
+      Range() = default;
+      Range(const T *begin, const T *end) : fBegin(begin), fEnd(end) {}
+
+      const T* begin() const { return fBegin; }
+      const T* end() const { return fEnd; }
+      std::size_t size() const { return fEnd - fBegin; }
+      bool empty() const { return fBegin == fEnd; }
+      const T& operator[](std::size_t i) const { return fBegin[i]; }
+
+    private:
+      const T *fBegin = nullptr;
+      const T *fEnd = nullptr;
+    };
+
+    TrackIDTable() = default;
+
+    /// Group (ID, value) pairs by ID
+    explicit TrackIDTable(std::vector<std::pair<int, T>> &&entries)
+    {
+      std::stable_sort(entries.begin(), entries.end(),
+                       [](const std::pair<int, T> &a, const std::pair<int, T> &b) { return a.first < b.first; });
+
+      fValues.reserve(entries.size());
+      for (std::pair<int, T> &entry: entries) {
+        if (fIDs.empty() || fIDs.back() != entry.first) {
+          fIDs.push_back(entry.first);
+          fOffsets.push_back(fValues.size());
+        }
+        fValues.push_back(std::move(entry.second));
+      }
+      fOffsets.push_back(fValues.size());
+    }
+
+    /// Values of \a id, empty if it has none
+    Range Find(int id) const
+    {
+      auto it = std::lower_bound(fIDs.begin(), fIDs.end(), id);
+      if (it == fIDs.end() || *it != id) return Range();
+
+      const std::size_t i = it - fIDs.begin();
+      return Range(fValues.data() + fOffsets[i], fValues.data() + fOffsets[i+1]);
+    }
+
+    bool Contains(int id) const { return std::binary_search(fIDs.begin(), fIDs.end(), id); }
+
+    /// Number of distinct IDs
+    std::size_t NIDs() const { return fIDs.size(); }
+
+  private:
+    std::vector<int> fIDs;             ///< Sorted, unique
+    std::vector<std::size_t> fOffsets; ///< fIDs.size()+1 entries into fValues
+    std::vector<T> fValues;
+  };
+
+  /// Energy depositions of each G4 track, with the wire they were seen on
+  using IDEMap = TrackIDTable<std::pair<geo::WireID, const sim::IDE*>>;
+
+  /// Hits each G4 track contributed to
+  using TrueHitMap = TrackIDTable<art::Ptr<recob::Hit>>;
+
+} // end namespace caf
+
+#endif
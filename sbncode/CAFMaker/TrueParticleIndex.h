@@ -0,0 +1,93 @@
+//////////////////////////////////////////////////////////////////////
+// \file    TrueParticleIndex.h
+// \brief   Per-event G4ID -> true particle lookup
+//////////////////////////////////////////////////////////////////////
+
+#ifndef CAF_TRUEPARTICLEINDEX_H
+#define CAF_TRUEPARTICLEINDEX_H
+
+#include "sbnanaobj/StandardRecord/SRTrueParticle.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace caf
+{
+  /// \brief Flat hash from G4ID to the position of a particle in the event's
+  /// SRTrueParticle vector
+  ///
+  /// Open addressing with linear probing in a power-of-two table at most half
+  /// full, so a lookup is a multiply, a shift and a short scan of contiguous
+  /// memory.
+  /// If several particles share a G4ID the first one wins, as with a linear
+  /// search of the vector.
+  class TrueParticleIndex
+  {
+  public:
+    TrueParticleIndex() = default;
+
+    explicit TrueParticleIndex(const std::vector<caf::SRTrueParticle> &particles)
+    {
+      std::size_t size = 16;
+      fShift = 28;
+      while (size < 2 * particles.size()) {
+        size *= 2;
+        fShift--;
+      }
+      fSlots.assign(size, Slot{0, -1});
+      fMask = size - 1;
+
+      for (std::size_t i = 0; i < particles.size(); i++) {
+        std::size_t s = Hash(particles[i].G4ID);
+        while (fSlots[s].index >= 0 && fSlots[s].g4id != particles[i].G4ID) s = (s + 1) & fMask;
+        if (fSlots[s].index < 0) fSlots[s] = Slot{particles[i].G4ID, (int)i};
+      }
+    }
+
+    /// Position of the particle with this G4ID, or -1 if there is none
+    int Find(int g4id) const
+    {
+      if (fSlots.empty()) return -1;
+
+      for (std::size_t s = Hash(g4id); fSlots[s].index >= 0; s = (s + 1) & fMask) {
+        if (fSlots[s].g4id == g4id) return fSlots[s].index;
+      }
+      return -1;
+    }
+
+    /// Position of the first particle whose G4ID is +/- \a g4id, or -1 if
+    /// there is none. For the parent of a particle, which is the absolute
+    /// value of the G4ID of particles whose ID was made negative.
+    int FindAbs(int g4id) const
+    {
+      if (g4id < 0) return -1;
+      const int pos = Find(g4id);
+      const int neg = (g4id == 0) ? -1 : Find(-g4id);
+      if (pos < 0) return neg;
+      if (neg < 0) return pos;
+      return std::min(pos, neg);
+    }
+
+  private:
+    struct Slot {
+      int g4id;
+      int index; ///< -1 for an empty slot
+    };
+
+    std::size_t Hash(int g4id) const
+    {
+      // Fibonacci hash: the top bits of the product depend on all the bits
+      // of the G4ID, so the generator offsets (multiples of 10^7 = 2^7 * 5^7)
+      // are spread over the table too, which the low bits would not do
+      return (std::size_t)(((uint32_t)g4id * 2654435769u) >> fShift);
+    }
+
+    std::vector<Slot> fSlots;
+    std::size_t fMask = 0;
+    unsigned int fShift = 28; ///< 32 - log2(table size)
+  };
+
+} // end namespace caf
+
+#endif
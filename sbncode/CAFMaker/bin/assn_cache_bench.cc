@@ -0,0 +1,175 @@
+// Per-event time of the association lookups CAFMaker::produce makes for
+// every slice, against the number of slices, done as art::FindManyP does
+// them (a scan of the whole Assns per slice and association) and through
+// the caf::KeyRangeIndex behind caf::AssnCache (one sort per event and
+// association, then a binary search per object). Needs no art, so the
+// association products are replaced by plain vectors of key pairs:
+//
+//   cafmaker_assn_cache_bench [events] [PFPs per slice] [hits per PFP]
+
+#include "sbncode/CAFMaker/KeyRangeIndex.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  // Stand-in for art::ProductID
+  struct ProductID {
+    unsigned short process;
+    unsigned short product;
+    bool operator<(const ProductID& o) const
+    {
+      return process < o.process || (process == o.process && product < o.product);
+    }
+    bool operator==(const ProductID& o) const
+    {
+      return process == o.process && product == o.product;
+    }
+  };
+
+  // Stand-in for art::Ptr
+  struct Ptr {
+    ProductID id;
+    std::size_t key;
+  };
+
+  // Stand-in for art::Assns<L, R>
+  using Assns = std::vector<std::pair<Ptr, Ptr>>;
+
+  // Number of FindManyP/FindOneP made per slice by CAFMaker::produce, and
+  // how many of them are to hits (many objects per left object)
+  const std::size_t kAssnsPerSlice = 78;
+  const std::size_t kHitAssns = 6;
+
+  std::size_t HashKey(const Ptr& p) { return (std::size_t(p.id.product) << 32) ^ p.key; }
+
+  // What art::FindManyP does for every slice: one pass over the whole
+  // association, looking each left object up in the requested ones. The
+  // lookup is a hash map here, which is the most favourable case for it.
+  std::size_t FindManyScan(const std::vector<Ptr>& from, const Assns& assns,
+                           std::vector<std::vector<Ptr>>& result)
+  {
+    std::unordered_map<std::size_t, std::size_t> position;
+    for (std::size_t i = 0; i < from.size(); i++) position[HashKey(from[i])] = i;
+    result.assign(from.size(), {});
+    std::size_t n = 0;
+    for (auto const& pr : assns) {
+      auto it = position.find(HashKey(pr.first));
+      if (it == position.end()) continue;
+      result[it->second].push_back(pr.second);
+      n++;
+    }
+    return n;
+  }
+
+  std::size_t FindManyIndexed(const std::vector<Ptr>& from, const Assns& assns,
+                              const caf::KeyRangeIndex<ProductID>& index,
+                              std::vector<std::vector<Ptr>>& result)
+  {
+    result.assign(from.size(), {});
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < from.size(); i++) {
+      const auto range = index.Range(from[i].id, from[i].key);
+      for (auto it = range.first; it != range.second; ++it) {
+        result[i].push_back(assns[it->index].second);
+        n++;
+      }
+    }
+    return n;
+  }
+
+  struct Event {
+    std::vector<std::vector<Ptr>> slicePFPs; ///< The left objects, per slice
+    std::vector<Assns> assns;                ///< One per association
+  };
+
+  Event MakeEvent(std::size_t nslices, std::size_t npfps, std::size_t nhits, std::mt19937& gen)
+  {
+    Event evt;
+    const ProductID pfpID{1, 1};
+    std::size_t key = 0;
+    for (std::size_t s = 0; s < nslices; s++) {
+      evt.slicePFPs.emplace_back();
+      for (std::size_t p = 0; p < npfps; p++) evt.slicePFPs.back().push_back({pfpID, key++});
+    }
+
+    // Producers write the pairs roughly in the order of the left objects
+    std::vector<Ptr> lefts;
+    for (auto const& slice : evt.slicePFPs) lefts.insert(lefts.end(), slice.begin(), slice.end());
+    for (std::size_t a = 0; a < kAssnsPerSlice; a++) {
+      const std::size_t nright = (a < kHitAssns) ? nhits : 1;
+      const ProductID rightID{1, static_cast<unsigned short>(a + 2)};
+      Assns assns;
+      std::size_t rkey = 0;
+      for (auto const& left : lefts) {
+        for (std::size_t r = 0; r < nright; r++) assns.push_back({left, {rightID, rkey++}});
+      }
+      std::shuffle(assns.begin(), assns.begin() + assns.size() / 10, gen);
+      evt.assns.push_back(std::move(assns));
+    }
+    return evt;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t nevents = (argc > 1) ? std::atol(argv[1]) : 20;
+  const std::size_t npfps = (argc > 2) ? std::atol(argv[2]) : 5;
+  const std::size_t nhits = (argc > 3) ? std::atol(argv[3]) : 200;
+
+  std::mt19937 gen(12345);
+  std::vector<std::vector<Ptr>> result;
+
+  std::cout << "slices   FindManyP scan [ms/event]   AssnCache [ms/event]   speedup" << std::endl;
+  for (std::size_t nslices : {1, 2, 5, 10, 20, 50, 100}) {
+    const Event evt = MakeEvent(nslices, npfps, nhits, gen);
+
+    std::size_t nscan = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t e = 0; e < nevents; e++) {
+      for (auto const& pfps : evt.slicePFPs) {
+        for (auto const& assns : evt.assns) nscan += FindManyScan(pfps, assns, result);
+      }
+    }
+    std::chrono::duration<double, std::milli> scan_time = std::chrono::steady_clock::now() - start;
+
+    std::size_t nindexed = 0;
+    start = std::chrono::steady_clock::now();
+    for (std::size_t e = 0; e < nevents; e++) {
+      // AssnCache: each association is indexed on first use in the event
+      std::vector<caf::KeyRangeIndex<ProductID>> indices(evt.assns.size());
+      for (std::size_t a = 0; a < evt.assns.size(); a++) {
+        indices[a].Reserve(evt.assns[a].size());
+        for (std::size_t i = 0; i < evt.assns[a].size(); i++) {
+          indices[a].Add(evt.assns[a][i].first.id, evt.assns[a][i].first.key, i);
+        }
+        indices[a].Sort();
+      }
+      for (auto const& pfps : evt.slicePFPs) {
+        for (std::size_t a = 0; a < evt.assns.size(); a++) {
+          nindexed += FindManyIndexed(pfps, evt.assns[a], indices[a], result);
+        }
+      }
+    }
+    std::chrono::duration<double, std::milli> indexed_time = std::chrono::steady_clock::now() - start;
+
+    if (nscan != nindexed) {
+      std::cerr << "Different number of associated objects: " << nscan << " and " << nindexed << std::endl;
+      return 1;
+    }
+
+    std::cout << std::setw(6) << nslices
+              << std::setw(28) << scan_time.count() / nevents
+              << std::setw(23) << indexed_time.count() / nevents
+              << std::setw(10) << scan_time.count() / indexed_time.count() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Memory and time CAFMaker spends making the record of the blind or
+// prescale stream of an event, with the default deep copy and with
+// BlindStreamsInPlace (header override of the unblinded record). The
+// blinding itself is the same in both cases, on one record, so it is left
+// out. The records are synthetic, with the shape of a busy MC event:
+//
+//   cafmaker_blind_stream_bench [events] [PFPs] [true particles] [weight universes]
+
+#include "sbnanaobj/StandardRecord/StandardRecord.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+  // Bytes allocated since the start, to measure the size of a copy
+  std::size_t gAllocated = 0;
+}
+
+void* operator new(std::size_t n)
+{
+  gAllocated += n;
+  if (void* p = std::malloc(n)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+  caf::StandardRecord MakeRecord(std::size_t npfps, std::size_t nparticles, std::size_t nuniv)
+  {
+    caf::StandardRecord rec;
+
+    rec.reco.pfp.resize(npfps);
+
+    rec.true_particles.resize(nparticles);
+    for (caf::SRTrueParticle& p : rec.true_particles) p.daughters.assign(3, 0);
+    rec.ntrue_particles = nparticles;
+
+    // Two neutrinos, with the flux and GENIE parameter sets
+    rec.mc.nu.resize(2);
+    rec.mc.nnu = 2;
+    for (caf::SRTrueInteraction& nu : rec.mc.nu) {
+      nu.wgt.resize(60);
+      for (auto& w : nu.wgt) w.univ.assign(nuniv, 1.f);
+    }
+    return rec;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t nevents = (argc > 1) ? std::atol(argv[1]) : 200;
+  const std::size_t npfps = (argc > 2) ? std::atol(argv[2]) : 300;
+  const std::size_t nparticles = (argc > 3) ? std::atol(argv[3]) : 20000;
+  const std::size_t nuniv = (argc > 4) ? std::atol(argv[4]) : 100;
+
+  auto prec = std::make_shared<caf::StandardRecord>(MakeRecord(npfps, nparticles, nuniv));
+
+  // Deep copy, as for the blind and prescale trees by default
+  std::chrono::duration<double, std::milli> copy_time{0};
+  std::size_t copy_bytes = 0;
+  for (std::size_t i = 0; i < nevents; i++) {
+    const std::size_t before = gAllocated;
+    const auto start = std::chrono::steady_clock::now();
+    auto pstreamrec = std::make_shared<caf::StandardRecord>(*prec);
+    pstreamrec->hdr.isblind = true;
+    copy_time += std::chrono::steady_clock::now() - start;
+    copy_bytes = gAllocated - before;
+  }
+
+  // In place: only the header is kept aside
+  std::chrono::duration<double, std::milli> inplace_time{0};
+  std::size_t inplace_bytes = 0;
+  for (std::size_t i = 0; i < nevents; i++) {
+    const std::size_t before = gAllocated;
+    const auto start = std::chrono::steady_clock::now();
+    caf::SRHeader streamhdr = prec->hdr;
+    streamhdr.isblind = true;
+    prec->hdr = std::move(streamhdr);
+    inplace_time += std::chrono::steady_clock::now() - start;
+    inplace_bytes = gAllocated - before;
+  }
+
+  std::cout << "deep copy: " << copy_time.count() / nevents << " ms/event, "
+            << copy_bytes / 1048576. << " MB more per event in flight" << std::endl
+            << "in place:  " << inplace_time.count() / nevents << " ms/event, "
+            << inplace_bytes / 1048576. << " MB more per event in flight" << std::endl;
+  return 0;
+}
@@ -0,0 +1,178 @@
+// Time of caf::GetG4ProcessID on a mix of Geant4 process names like the
+// one of the particles FillTrueG4Particle saves in cosmic-heavy MC, for the
+// table lookup of G4ProcessTable.h and for the chain of string compares it
+// replaced. Needs the sbnanaobj headers only:
+//
+//   cafmaker_g4process_bench [particles] [repetitions]
+
+#include "sbncode/CAFMaker/G4ProcessTable.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // GetG4ProcessID before the table
+  caf::g4_process_ ChainG4ProcessID(const std::string &process_name) {
+#define MATCH_PROCESS(name) if (process_name == #name) {return caf::kG4 ## name;}
+#define MATCH_PROCESS_NAMED(strname, id) if (process_name == #strname) {return caf::kG4 ## id;}
+    MATCH_PROCESS(primary)
+    MATCH_PROCESS(CoupledTransportation)
+    MATCH_PROCESS(FastScintillation)
+    MATCH_PROCESS(Decay)
+    MATCH_PROCESS(anti_neutronInelastic)
+    MATCH_PROCESS(neutronInelastic)
+    MATCH_PROCESS(anti_protonInelastic)
+    MATCH_PROCESS(protonInelastic)
+    MATCH_PROCESS(hadInelastic)
+    MATCH_PROCESS_NAMED(kaon+Inelastic, kaonpInelastic)
+    MATCH_PROCESS_NAMED(kaon-Inelastic, kaonmInelastic)
+    MATCH_PROCESS_NAMED(kaon+Inelastic, kaonpInelastic)
+    MATCH_PROCESS_NAMED(kaon-Inelastic, kaonmInelastic)
+    MATCH_PROCESS_NAMED(sigma+Inelastic, sigmapInelastic)
+    MATCH_PROCESS_NAMED(sigma-Inelastic, sigmamInelastic)
+    MATCH_PROCESS_NAMED(pi+Inelastic, pipInelastic)
+    MATCH_PROCESS_NAMED(pi-Inelastic, pimInelastic)
+    MATCH_PROCESS_NAMED(xi+Inelastic, xipInelastic)
+    MATCH_PROCESS_NAMED(xi-Inelastic, ximInelastic)
+    MATCH_PROCESS(kaon0LInelastic)
+    MATCH_PROCESS(kaon0SInelastic)
+    MATCH_PROCESS(lambdaInelastic)
+    MATCH_PROCESS_NAMED(anti-lambdaInelastic, anti_lambdaInelastic)
+    MATCH_PROCESS(He3Inelastic)
+    MATCH_PROCESS(ionInelastic)
+    MATCH_PROCESS(xi0Inelastic)
+    MATCH_PROCESS(alphaInelastic)
+    MATCH_PROCESS(tInelastic)
+    MATCH_PROCESS(dInelastic)
+    MATCH_PROCESS(anti_neutronElastic)
+    MATCH_PROCESS(neutronElastic)
+    MATCH_PROCESS(anti_protonElastic)
+    MATCH_PROCESS(protonElastic)
+    MATCH_PROCESS(hadElastic)
+    MATCH_PROCESS_NAMED(kaon+Elastic, kaonpElastic)
+    MATCH_PROCESS_NAMED(kaon-Elastic, kaonmElastic)
+    MATCH_PROCESS_NAMED(pi+Elastic, pipElastic)
+    MATCH_PROCESS_NAMED(pi-Elastic, pimElastic)
+    MATCH_PROCESS(conv)
+    MATCH_PROCESS(phot)
+    MATCH_PROCESS(annihil)
+    MATCH_PROCESS(nCapture)
+    MATCH_PROCESS(nKiller)
+    MATCH_PROCESS(muMinusCaptureAtRest)
+    MATCH_PROCESS(muIoni)
+    MATCH_PROCESS(eBrem)
+    MATCH_PROCESS(CoulombScat)
+    MATCH_PROCESS(hBertiniCaptureAtRest)
+    MATCH_PROCESS(hFritiofCaptureAtRest)
+    MATCH_PROCESS(photonNuclear)
+    MATCH_PROCESS(muonNuclear)
+    MATCH_PROCESS(electronNuclear)
+    MATCH_PROCESS(positronNuclear)
+    MATCH_PROCESS(compt)
+    MATCH_PROCESS(eIoni)
+    MATCH_PROCESS(muBrems)
+    MATCH_PROCESS(hIoni)
+    MATCH_PROCESS(ionIoni)
+    MATCH_PROCESS(hBrems)
+    MATCH_PROCESS(muPairProd)
+    MATCH_PROCESS(hPairProd)
+    MATCH_PROCESS(LArVoxelReadoutScoringProcess)
+    MATCH_PROCESS(Transportation)
+    MATCH_PROCESS(msc)
+    MATCH_PROCESS(StepLimiter)
+#undef MATCH_PROCESS
+#undef MATCH_PROCESS_NAMED
+    return caf::kG4UNKNOWN;
+  }
+
+  struct Weighted {
+    const char* name;
+    double weight;
+  };
+
+  // Rough shares of the start and end processes of the saved particles in
+  // cosmic overlay MC: mostly electromagnetic secondaries, which end in
+  // ionisation, then hadronic products and particles leaving the volume
+  const std::vector<Weighted> kStartProcesses {
+    {"primary", 2.}, {"compt", 22.}, {"eIoni", 18.}, {"phot", 12.}, {"conv", 6.},
+    {"eBrem", 8.}, {"muIoni", 8.}, {"hadElastic", 3.}, {"neutronInelastic", 6.},
+    {"protonInelastic", 3.}, {"pi+Inelastic", 1.}, {"pi-Inelastic", 1.}, {"nCapture", 4.},
+    {"Decay", 2.}, {"muMinusCaptureAtRest", 1.}, {"hIoni", 1.}, {"annihil", 1.},
+    {"photonNuclear", 0.5}, {"muonNuclear", 0.5},
+  };
+  const std::vector<Weighted> kEndProcesses {
+    {"eIoni", 30.}, {"phot", 15.}, {"compt", 10.}, {"conv", 5.}, {"CoupledTransportation", 15.},
+    {"hIoni", 4.}, {"muIoni", 2.}, {"neutronInelastic", 5.}, {"protonInelastic", 3.},
+    {"hadElastic", 2.}, {"nCapture", 4.}, {"Decay", 2.}, {"annihil", 1.},
+    {"pi+Inelastic", 0.5}, {"pi-Inelastic", 0.5}, {"StepLimiter", 1.},
+  };
+
+  std::vector<std::string> Sample(const std::vector<Weighted>& procs, std::size_t n, std::mt19937& gen)
+  {
+    std::vector<double> weights;
+    for (auto const& p : procs) weights.push_back(p.weight);
+    std::discrete_distribution<std::size_t> pick(weights.begin(), weights.end());
+    std::vector<std::string> ret;
+    ret.reserve(n);
+    for (std::size_t i = 0; i < n; i++) ret.emplace_back(procs[pick(gen)].name);
+    return ret;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t nparticles = (argc > 1) ? std::atol(argv[1]) : 100000;
+  const std::size_t nrepeat = (argc > 2) ? std::atol(argv[2]) : 20;
+
+  // Start then end process of each particle, as FillTrueG4Particle asks
+  std::mt19937 gen(12345);
+  const std::vector<std::string> start = Sample(kStartProcesses, nparticles, gen);
+  const std::vector<std::string> end = Sample(kEndProcesses, nparticles, gen);
+  std::vector<const std::string*> names;
+  for (std::size_t i = 0; i < nparticles; i++) {
+    names.push_back(&start[i]);
+    names.push_back(&end[i]);
+  }
+
+  long chain_sum = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < nrepeat; r++) {
+    for (const std::string* name : names) chain_sum += ChainG4ProcessID(*name);
+  }
+  std::chrono::duration<double, std::nano> chain_time = std::chrono::steady_clock::now() - t0;
+
+  long table_sum = 0;
+  t0 = std::chrono::steady_clock::now();
+  for (std::size_t r = 0; r < nrepeat; r++) {
+    for (const std::string* name : names) {
+      caf::g4_process_ id = caf::kG4UNKNOWN;
+      caf::LookupG4Process(*name, id);
+      table_sum += id;
+    }
+  }
+  std::chrono::duration<double, std::nano> table_time = std::chrono::steady_clock::now() - t0;
+
+  // Every name of the old chain must give the same ID
+  for (auto const& entry : caf::detail::kG4ProcessTable) {
+    caf::g4_process_ id = caf::kG4UNKNOWN;
+    if (!caf::LookupG4Process(entry.first, id) || id != ChainG4ProcessID(std::string(entry.first))) {
+      std::cerr << "Different IDs for " << entry.first << std::endl;
+      return 1;
+    }
+  }
+  if (chain_sum != table_sum) {
+    std::cerr << "Different IDs on the sample" << std::endl;
+    return 1;
+  }
+
+  const double ncalls = double(names.size()) * nrepeat;
+  std::cout << "string compare chain: " << chain_time.count() / ncalls << " ns/name" << std::endl
+            << "sorted table:         " << table_time.count() / ncalls << " ns/name" << std::endl;
+  return 0;
+}
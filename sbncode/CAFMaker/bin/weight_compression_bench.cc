@@ -0,0 +1,221 @@
+// Compressed size and read time of mc.nu.wgt.univ with the options of
+// sbncode/SBNEventWeight/Base/WeightCompression.h: as it is, with the
+// all-ones universes stored as a single weight (DropAllOnesSystWeights),
+// quantised to half precision (QuantizeSystWeights), and both. The weights
+// are streamed as ROOT writes a split vector<float> branch (size, then
+// big-endian floats) into 32000 byte baskets, and compressed with ROOT's
+// own compression: ZLIB 1 as for the structured CAF, LZ4 1 as for the flat
+// one. Reading unzips the baskets, swaps the bytes back and expands the
+// single weights to nuniv. The weights are synthetic, in the shape of a
+// flux plus GENIE systematics job:
+//
+//   cafmaker_weight_compression_bench [neutrinos]
+
+#include "sbncode/SBNEventWeight/Base/WeightCompression.h"
+
+#include "Compression.h"
+#include "RZip.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  const int kBasketSize = 32000;
+
+  /// Number of universes of each parameter set, as in SRGlobal
+  std::vector<std::size_t> MakeParameterSets()
+  {
+    std::vector<std::size_t> nuniv;
+    nuniv.insert(nuniv.end(), 9, 1000); // flux: horn, skin, 7 hadron production
+    nuniv.push_back(500);               // GENIE multisim
+    nuniv.insert(nuniv.end(), 40, 7);   // GENIE multisigma
+    return nuniv;
+  }
+
+  /// Weights of one neutrino for every parameter set
+  std::vector<std::vector<float>> MakeNeutrino(const std::vector<std::size_t>& nuniv, std::mt19937& gen)
+  {
+    std::lognormal_distribution<float> flux(0., 0.1), horn(0., 0.02), genie(0., 0.15);
+    std::vector<std::vector<float>> sets(nuniv.size());
+    // Only the hadron production sets of the neutrino parent are not all ones
+    const std::size_t parent = 2 + gen() % 4;
+    for (std::size_t s = 0; s < nuniv.size(); s++) {
+      std::vector<float>& w = sets[s];
+      w.assign(nuniv[s], 1.f);
+      if (s < 2) for (float& x : w) x = horn(gen);
+      else if (s < 9) { if (s == parent || s == parent + 3) for (float& x : w) x = flux(gen); }
+      else if (s == 9) for (float& x : w) x = genie(gen);
+      else if (gen() % 2) {
+        // Multisigma: -3 to +3 sigma, the knob changing this interaction
+        const float slope = 0.1f * std::abs(genie(gen) - 1.f);
+        for (std::size_t u = 0; u < w.size(); u++) w[u] = 1.f + slope * (int(u) - 3);
+      }
+    }
+    return sets;
+  }
+
+  void PutBigEndian(std::vector<char>& buf, std::uint32_t v)
+  {
+    for (int i = 3; i >= 0; i--) buf.push_back(char((v >> (8 * i)) & 0xFF));
+  }
+
+  std::uint32_t GetBigEndian(const unsigned char* p)
+  {
+    return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+  }
+
+  struct Basket {
+    std::vector<unsigned char> data;
+    int nbytes;        ///< Uncompressed size
+    bool compressed;
+  };
+
+  struct Result {
+    std::size_t rawBytes = 0;
+    std::size_t zipBytes = 0;
+    double readSeconds = 0;
+    std::size_t nDiffer = 0;
+  };
+
+  Result Run(const std::vector<std::vector<std::vector<float>>>& nus, const std::vector<std::size_t>& nuniv,
+             bool dropAllOnes, bool quantize, ROOT::RCompressionSetting::EAlgorithm::EValues algo)
+  {
+    Result res;
+
+    // Write, as CAFMaker's FillEventWeight would fill the record
+    std::vector<Basket> baskets;
+    std::vector<char> buf;
+    auto flush = [&]() {
+      if (buf.empty()) return;
+      Basket b;
+      b.nbytes = buf.size();
+      b.data.resize(buf.size() + buf.size() / 2 + 64);
+      int srcsize = buf.size(), tgtsize = b.data.size(), irep = 0;
+      R__zipMultipleAlgorithm(1, &srcsize, buf.data(), &tgtsize, reinterpret_cast<char*>(b.data.data()), &irep, algo);
+      // As TBasket: kept uncompressed when compression does not help
+      b.compressed = irep > 0 && irep < b.nbytes;
+      if (b.compressed) b.data.resize(irep);
+      else b.data.assign(buf.begin(), buf.end());
+      res.rawBytes += b.nbytes;
+      res.zipBytes += b.data.size();
+      baskets.push_back(std::move(b));
+      buf.clear();
+    };
+    std::vector<float> univ;
+    for (auto const& sets : nus) {
+      for (auto const& w : sets) {
+        if (dropAllOnes && sbn::evwgh::AllOnes(w)) univ.assign(1, 1.f);
+        else {
+          univ = w;
+          if (quantize) sbn::evwgh::QuantizeWeights(univ);
+        }
+        PutBigEndian(buf, univ.size());
+        for (float x : univ) {
+          std::uint32_t bits;
+          std::memcpy(&bits, &x, sizeof bits);
+          PutBigEndian(buf, bits);
+        }
+        if (buf.size() >= std::size_t(kBasketSize)) flush();
+      }
+    }
+    flush();
+
+    // Read back, as a CAF reader would. Each vector is handed to use()
+    std::vector<unsigned char> unzipped;
+    std::vector<float> w;
+    auto read = [&](auto use) {
+      std::size_t inu = 0, iset = 0;
+      for (auto& b : baskets) {
+        const unsigned char* p = b.data.data();
+        if (b.compressed) {
+          unzipped.resize(b.nbytes);
+          int srcsize = b.data.size(), tgtsize = b.nbytes, irep = 0;
+          R__unzip(&srcsize, b.data.data(), &tgtsize, unzipped.data(), &irep);
+          if (irep != b.nbytes) {
+            std::cerr << "Failed to unzip a basket" << std::endl;
+            std::exit(1);
+          }
+          p = unzipped.data();
+        }
+        const unsigned char* end = p + b.nbytes;
+        while (p < end) {
+          const std::uint32_t n = GetBigEndian(p);
+          p += 4;
+          w.resize(n);
+          for (std::uint32_t i = 0; i < n; i++, p += 4) {
+            const std::uint32_t bits = GetBigEndian(p);
+            std::memcpy(&w[i], &bits, sizeof bits);
+          }
+          // A single weight is that of every universe
+          if (n == 1) w.assign(nuniv[iset], w[0]);
+          use(inu, iset, w);
+          if (++iset == nuniv.size()) { iset = 0; inu++; }
+        }
+      }
+    };
+
+    double sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    read([&](std::size_t, std::size_t, const std::vector<float>& v) { if (!v.empty()) sum += v[0]; });
+    res.readSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sum < 0) std::cout << sum << std::endl;
+
+    read([&](std::size_t inu, std::size_t iset, const std::vector<float>& v) {
+      const std::vector<float>& orig = nus[inu][iset];
+      if (v.size() != orig.size()) { res.nDiffer++; return; }
+      for (std::size_t i = 0; i < v.size(); i++) {
+        const float expected = quantize ? sbn::evwgh::QuantizeWeight(orig[i]) : orig[i];
+        if (v[i] != expected) { res.nDiffer++; return; }
+      }
+    });
+    return res;
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t nnu = (argc > 1) ? std::atol(argv[1]) : 2000;
+
+  const std::vector<std::size_t> nuniv = MakeParameterSets();
+  std::mt19937 gen(12345);
+  std::vector<std::vector<std::vector<float>>> nus;
+  for (std::size_t i = 0; i < nnu; i++) nus.push_back(MakeNeutrino(nuniv, gen));
+
+  struct Variant { const char* name; bool dropAllOnes, quantize; };
+  const Variant variants[] = {
+    { "as is", false, false },
+    { "DropAllOnesSystWeights", true, false },
+    { "QuantizeSystWeights", false, true },
+    { "both", true, true },
+  };
+  struct Algo { const char* name; ROOT::RCompressionSetting::EAlgorithm::EValues algo; };
+  const Algo algos[] = {
+    { "ZLIB 1", ROOT::RCompressionSetting::EAlgorithm::kZLIB },
+    { "LZ4 1", ROOT::RCompressionSetting::EAlgorithm::kLZ4 },
+  };
+
+  std::size_t nDiffer = 0;
+  std::cout << std::setw(8) << "" << std::setw(24) << "" << std::setw(14) << "raw [kB/nu]"
+            << std::setw(18) << "on disk [kB/nu]" << std::setw(16) << "read [us/nu]" << std::endl;
+  for (auto const& a : algos) {
+    for (auto const& v : variants) {
+      const Result res = Run(nus, nuniv, v.dropAllOnes, v.quantize, a.algo);
+      nDiffer += res.nDiffer;
+      std::cout << std::setw(8) << a.name << std::setw(24) << v.name
+                << std::setw(14) << std::fixed << std::setprecision(2) << res.rawBytes / 1024. / nnu
+                << std::setw(18) << res.zipBytes / 1024. / nnu
+                << std::setw(16) << std::setprecision(1) << res.readSeconds * 1e6 / nnu << std::endl;
+    }
+  }
+  if (nDiffer) std::cerr << nDiffer << " weight vectors read back differently" << std::endl;
+  return nDiffer ? 1 : 0;
+}
@@ -284,8 +284,8 @@ void sbn::TrackCaloSkimmer::analyze(art::Event const& e)
   // Prep truth-to-reco-matching info
   //
   // Use helper functions from CAFMaker/FillTrue
-  std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> id_to_ide_map;
-  std::map<int, std::vector<art::Ptr<recob::Hit>>> id_to_truehit_map;
+  caf::IDEMap id_to_ide_map;
+  caf::TrueHitMap id_to_truehit_map;
   const cheat::BackTrackerService *bt = NULL;
 
   if (simchannels.size()) {
@@ -521,17 +521,14 @@ geo::Point_t WireToTrajectoryPosition(const geo::Point_t &loc, const geo::TPCID
 sbn::TrueParticle TrueParticleInfo(const simb::MCParticle &particle,
     const std::vector<geo::BoxBoundedGeo> &active_volumes,
     const std::vector<std::vector<geo::BoxBoundedGeo>> &tpc_volumes,
-    const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE *>>> &id_to_ide_map,
-    const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map, 
+    const caf::IDEMap &id_to_ide_map,
+    const caf::TrueHitMap &id_to_truehit_map, 
     const detinfo::DetectorPropertiesData &dprop,
     const geo::GeometryCore *geo,
     const geo::WireReadoutGeom *wireReadout) {
 
-  std::vector<std::pair<geo::WireID, const sim::IDE *>> empty;
-  const std::vector<std::pair<geo::WireID, const sim::IDE *>> &particle_ides = id_to_ide_map.count(particle.TrackId()) ? id_to_ide_map.at(particle.TrackId()) : empty;
-  
-  std::vector<art::Ptr<recob::Hit>> emptyHits;
-  const std::vector<art::Ptr<recob::Hit>> &particle_hits = id_to_truehit_map.count(particle.TrackId()) ? id_to_truehit_map.at(particle.TrackId()) : emptyHits;
+  const caf::IDEMap::Range particle_ides = id_to_ide_map.Find(particle.TrackId());
+  const caf::TrueHitMap::Range particle_hits = id_to_truehit_map.Find(particle.TrackId());
 
   sbn::TrueParticle trueparticle;
 
@@ -987,8 +984,8 @@ void sbn::TrackCaloSkimmer::FillTrackTruth(const detinfo::DetectorClocksData &cl
     const std::vector<art::Ptr<simb::MCParticle>> &mcparticles,
     const std::vector<geo::BoxBoundedGeo> &active_volumes,
     const std::vector<std::vector<geo::BoxBoundedGeo>> &tpc_volumes,
-    const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> id_to_ide_map,
-    const std::map<int, std::vector<art::Ptr<recob::Hit>>> id_to_truehit_map,
+    const caf::IDEMap &id_to_ide_map,
+    const caf::TrueHitMap &id_to_truehit_map,
     const detinfo::DetectorPropertiesData &dprop,
     const geo::GeometryCore *geo,
     const geo::WireReadoutGeom *wireReadout) {
@@ -0,0 +1,247 @@
+#ifndef SBN_FLASHMATCH_FIXEDHISTOGRAM_HH
+#define SBN_FLASHMATCH_FIXEDHISTOGRAM_HH
+
+// Fixed binning 1D histogram and weighted moments, for the per slice and per
+// event metrics of FlashPredict. They reproduce what TH1F/TH1D return for
+// the same fills, but are plain objects: no ROOT directory, name registry
+// or lock, and no allocation when a histogram is Reset() with a binning
+// that fits its storage.
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace sbn {
+
+  /// Weighted moments of the values filled in [low, high). As in TH1,
+  /// values outside the range count as entries but not in the moments.
+  class MomentAccumulator {
+  public:
+    MomentAccumulator(double low = 0., double high = 0.)
+      : fLow(low), fHigh(high)
+    {}
+
+    void Fill(double x, double w)
+    {
+      fEntries += 1.;
+      if (x < fLow || !(x < fHigh)) return;
+      fSumw   += w;
+      fSumw2  += w*w;
+      fSumwx  += w*x;
+      fSumwx2 += w*x*x;
+    }
+
+    void Reset(double low, double high)
+    {
+      *this = MomentAccumulator(low, high);
+    }
+
+    double Entries() const { return fEntries; }
+    double SumW() const { return fSumw; }
+
+    /// As TH1::GetMean(), 0 if nothing was filled in range
+    double Mean() const
+    {
+      if (fSumw == 0.) return 0.;
+      return fSumwx/fSumw;
+    }
+
+    /// As TH1::GetStdDev(), 0 if nothing was filled in range
+    double StdDev() const
+    {
+      if (fSumw == 0.) return 0.;
+      double x = fSumwx/fSumw;
+      return std::sqrt(std::abs(fSumwx2/fSumw - x*x));
+    }
+
+  private:
+    template <class T> friend class FixedHistogram;
+
+    double fLow, fHigh;
+    double fEntries = 0.;
+    double fSumw = 0., fSumw2 = 0., fSumwx = 0., fSumwx2 = 0.;
+  };
+
+
+  /// Histogram of nbins equal bins in [low, high), plus underflow (bin 0)
+  /// and overflow (bin nbins+1). The bin contents are stored as T: float
+  /// behaves as TH1F, double as TH1D.
+  template <class T>
+  class FixedHistogram {
+  public:
+    FixedHistogram() = default;
+
+    FixedHistogram(int nbins, double low, double high)
+    { Reset(nbins, low, high); }
+
+    /// Empty the histogram and set its binning, reusing its storage
+    void Reset(int nbins, double low, double high)
+    {
+      fNBins = nbins;
+      fLow = low;
+      fHigh = high;
+      fContent.assign(nbins + 2, T(0));
+      fMoments.Reset(low, high);
+    }
+
+    /// Empty the histogram, as TH1::Reset()
+    void Reset()
+    { Reset(fNBins, fLow, fHigh); }
+
+    int NBins() const { return fNBins; }
+
+    /// As TAxis::FindBin()
+    int FindBin(double x) const
+    {
+      if (x < fLow) return 0;
+      if (!(x < fHigh)) return fNBins + 1;
+      return std::min(1 + int(fNBins*(x - fLow)/(fHigh - fLow)), fNBins);
+    }
+
+    /// As TAxis::GetBinCenter()
+    double BinCenter(int bin) const
+    {
+      double binwidth = (fHigh - fLow)/double(fNBins);
+      return fLow + (bin - 1)*binwidth + 0.5*binwidth;
+    }
+
+    double BinContent(int bin) const { return fContent[bin]; }
+
+    void Fill(double x, double w)
+    {
+      fContent[FindBin(x)] += T(w);
+      fMoments.Fill(x, w);
+    }
+
+    /// As TH1::SetBinContent(): it also counts as an entry, and the moments
+    /// are then computed from the bin centers
+    void SetBinContent(int bin, double content)
+    {
+      fContent[bin] = T(content);
+      fMoments.fEntries += 1.;
+      fMoments.fSumw = 0.;
+    }
+
+    double Entries() const { return fMoments.Entries(); }
+
+    /// Sum of the contents of bins 1 to nbins
+    double Integral() const
+    { return Integral(1, fNBins); }
+
+    /// Sum of the contents of bins first to last, as TH1::Integral(first, last)
+    double Integral(int first, int last) const
+    {
+      if (first < 0) first = 0;
+      if (last > fNBins + 1 || last < first) last = fNBins + 1;
+      double integral = 0.;
+      for (int bin = first; bin <= last; ++bin) integral += fContent[bin];
+      return integral;
+    }
+
+    /// First bin with the largest content, in all the bins or between first
+    /// and last as TH1::GetMaximumBin() after TAxis::SetRange(first, last)
+    int MaximumBin(int first = 0, int last = 0) const
+    {
+      const int ncells = fNBins + 1;
+      if (last < first || (first < 0 && last < 0) ||
+          (first < 0 && last > ncells) ||
+          (first > ncells && last > ncells) ||
+          (first == 0 && last == 0)) {
+        first = 1;
+        last = fNBins;
+      }
+      else {
+        first = std::max(first, 0);
+        last = std::min(last, ncells);
+      }
+
+      int maxbin = 0;
+      double maximum = -FLT_MAX;
+      for (int bin = first; bin <= last; ++bin) {
+        double value = fContent[bin];
+        if (value > maximum) {
+          maximum = value;
+          maxbin = bin;
+        }
+      }
+      return maxbin;
+    }
+
+    /// As TH1::GetMean()
+    double Mean() const
+    {
+      if (UseBinMoments()) return BinMoments().Mean();
+      return fMoments.Mean();
+    }
+
+    /// As TH1::GetStdDev()
+    double StdDev() const
+    {
+      if (UseBinMoments()) return BinMoments().StdDev();
+      return fMoments.StdDev();
+    }
+
+    /// As TH1::GetSkewness(), from the bin centers
+    double Skewness() const
+    {
+      double mean = Mean();
+      double stddev = StdDev();
+      double stddev3 = stddev*stddev*stddev;
+      double sum = 0., np = 0.;
+      for (int bin = 1; bin <= fNBins; ++bin) {
+        double x = BinCenter(bin);
+        double w = fContent[bin];
+        np += w;
+        sum += w*(x-mean)*(x-mean)*(x-mean);
+      }
+      sum /= np*stddev3;
+      return sum;
+    }
+
+    /// As TH1::GetKurtosis() (excess kurtosis), from the bin centers
+    double Kurtosis() const
+    {
+      double mean = Mean();
+      double stddev = StdDev();
+      double stddev4 = stddev*stddev*stddev*stddev;
+      double sum = 0., np = 0.;
+      for (int bin = 1; bin <= fNBins; ++bin) {
+        double x = BinCenter(bin);
+        double w = fContent[bin];
+        np += w;
+        sum += w*(x-mean)*(x-mean)*(x-mean)*(x-mean);
+      }
+      sum /= (np*stddev4);
+      return sum - 3;
+    }
+
+  private:
+    /// TH1::GetStats() falls back to the bin contents when the in-range
+    /// weights sum to 0 after some entries
+    bool UseBinMoments() const
+    { return fMoments.fSumw == 0. && fMoments.fEntries > 0.; }
+
+    MomentAccumulator BinMoments() const
+    {
+      MomentAccumulator moments(fLow, fHigh);
+      for (int bin = 1; bin <= fNBins; ++bin) {
+        double w = fContent[bin];
+        double x = BinCenter(bin);
+        moments.fSumw   += w;
+        moments.fSumw2  += w*w;
+        moments.fSumwx  += w*x;
+        moments.fSumwx2 += w*x*x;
+      }
+      return moments;
+    }
+
+    int fNBins = 0;
+    double fLow = 0., fHigh = 0.;
+    std::vector<T> fContent; ///< Underflow, nbins bins, overflow
+    MomentAccumulator fMoments;
+  };
+
+} // namespace sbn
+
+#endif // SBN_FLASHMATCH_FIXEDHISTOGRAM_HH
@@ -49,6 +49,8 @@
 #include "TH2.h"
 #include "TProfile3D.h"
 
+#include "sbncode/FlashMatch/FixedHistogram.hh"
+#include "sbncode/FlashMatch/MetricTable3D.hh"
 #include "sbncode/OpT0Finder/flashmatch/Base/OpT0FinderTypes.h"
 #include "sbncode/OpDet/PDMapAlg.h"
 #include "sbnobj/Common/Reco/SimpleFlashMatchVars.h"
@@ -57,6 +59,7 @@
 #include "nusimdata/SimulationBase/MCTruth.h"
 
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <limits>
 #include <list>
@@ -98,8 +101,7 @@ public:
     TH2D* RRH2; TH2D* RatioH2;
     std::array<Fits, 3> RRFits; // LEGACY
     std::array<Fits, 3> RatioFits; // LEGACY
-    TProfile3D* dYP3; TProfile3D* dZP3; TProfile3D* RRP3;
-    TProfile3D* RatioP3; TProfile3D* SlopeP3; TProfile3D* PEToQP3;
+    sbn::MetricTable3D Metrics3D; // dY, dZ, RR, Ratio, Slope and PEToQ profiles
   };
 
   struct ChargeDigest {
@@ -314,10 +316,10 @@ private:
                           const double mean, const double spread) const;
   inline double scoreTerm3D(
     const double m, const double n,
-    const int xb, const int yb, const int zb, const TProfile3D* prof3) const;
+    const sbn::MetricTable3D::Entry& entry) const;
   inline double scoreTerm3D(
     const double m,
-    const int xb, const int yb, const int zb, const TProfile3D* prof3) const;
+    const sbn::MetricTable3D::Entry& entry) const;
   inline double PEToQ(const double pe, const double q) const;
   inline bool pfpNeutrinoOnEvent(
     const art::ValidHandle<std::vector<recob::PFParticle>>& pfps_h) const;
@@ -334,17 +336,17 @@ private:
     const std::vector<recob::OpHit>& opHits,
     std::vector<recob::OpHit>& opHitsRght,
     std::vector<recob::OpHit>& opHitsLeft,
-    std::unique_ptr<TH1D>& opHitsTimeHist,
-    std::unique_ptr<TH1D>& opHitsTimeHistRght,
-    std::unique_ptr<TH1D>& opHitsTimeHistLeft) const;
+    sbn::FixedHistogram<double>& opHitsTimeHist,
+    sbn::FixedHistogram<double>& opHitsTimeHistRght,
+    sbn::FixedHistogram<double>& opHitsTimeHistLeft) const;
   unsigned createOpHitsTimeHist(//ICARUS overload
     const std::vector<recob::OpHit>& opHits,
-    std::unique_ptr<TH1D>& opHitsTimeHist) const;
+    sbn::FixedHistogram<double>& opHitsTimeHist) const;
   bool findSimpleFlashes(
     std::vector<SimpleFlash>& simpleFlashes,
     std::vector<recob::OpHit>& opHits,
     const unsigned ophsInVolume,
-    std::unique_ptr<TH1D>& opHitsTimeHist) const;
+    sbn::FixedHistogram<double>& opHitsTimeHist) const;
   inline std::string detectorName(const std::string detName) const;
   bool isPDInCryo(const int pdChannel) const;
   // bool isSBNDPDRelevant(const int pdChannel,
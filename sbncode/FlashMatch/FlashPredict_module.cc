@@ -673,20 +673,20 @@ FlashPredict::ReferenceMetrics FlashPredict::loadMetrics(
 
   // BIG TODO: Metrics should depend on X,Y,Z.
   // TODO: Test!
-  // TODO: store 3D-arrays of means and spreads, instead of the
-  // TProfile3D
-  TProfile3D* tmp1_prof3 = (TProfile3D*)infile->Get("dy_prof3");
-  rm.dYP3 = (TProfile3D*)tmp1_prof3->Clone("dYP3");
-  TProfile3D* tmp2_prof3 = (TProfile3D*)infile->Get("dz_prof3");
-  rm.dZP3 = (TProfile3D*)tmp2_prof3->Clone("dZP3");
-  TProfile3D* tmp3_prof3 = (TProfile3D*)infile->Get("rr_prof3");
-  rm.RRP3 = (TProfile3D*)tmp3_prof3->Clone("RRP3");
-  TProfile3D* tmp4_prof3 = (TProfile3D*)infile->Get("ratio_prof3");
-  rm.RatioP3 = (TProfile3D*)tmp4_prof3->Clone("RatioP3");
-  TProfile3D* tmp5_prof3 = (TProfile3D*)infile->Get("slope_prof3");
-  rm.SlopeP3 = (TProfile3D*)tmp5_prof3->Clone("SlopeP3");
-  TProfile3D* tmp6_prof3 = (TProfile3D*)infile->Get("petoq_prof3");
-  rm.PEToQP3 = (TProfile3D*)tmp6_prof3->Clone("PEToQP3");
+  // The means and spreads of the profiles are copied into one dense
+  // table, in the order of sbn::MetricTable3D::Metric
+  std::array<const TProfile3D*, sbn::MetricTable3D::kNMetrics> prof3s = {
+    (TProfile3D*)infile->Get("dy_prof3"), (TProfile3D*)infile->Get("dz_prof3"),
+    (TProfile3D*)infile->Get("rr_prof3"), (TProfile3D*)infile->Get("ratio_prof3"),
+    (TProfile3D*)infile->Get("slope_prof3"), (TProfile3D*)infile->Get("petoq_prof3")};
+  for(const TAxis* axis : {prof3s[0]->GetXaxis(), prof3s[0]->GetYaxis(), prof3s[0]->GetZaxis()}) {
+    if(axis->IsVariableBinSize()) {
+      throw cet::exception("FlashPredict")
+        << "The 3D metrics in '" << fname
+        << "' must have fixed size bins\n";
+    }
+  }
+  rm.Metrics3D = sbn::MetricTable3D(prof3s);
 
   infile->Close();
   delete infile;
@@ -765,19 +765,21 @@ FlashPredict::ChargeMetrics FlashPredict::computeChargeMetrics(
 
   // Compute the widths
   // TODO: unharcode... but these numbers work for SBND and ICARUS
-  std::unique_ptr<TH1F> qX = std::make_unique<TH1F>("qX", "", 160, -400., 400.);
-  std::unique_ptr<TH1F> qY = std::make_unique<TH1F>("qY", "",  84, -210., 210.);
-  std::unique_ptr<TH1F> qZ = std::make_unique<TH1F>("qZ", "", 364, -910., 910.);
+  // Only the widths are needed, the ranges are those of the former
+  // 160, 84 and 364 bins histograms
+  sbn::MomentAccumulator qX(-400., 400.);
+  sbn::MomentAccumulator qY(-210., 210.);
+  sbn::MomentAccumulator qZ(-910., 910.);
   for (size_t i=0; i<qClusters.size(); ++i) {
     // double q2 = qClusters[i].q * qClusters[i].q;
     double q = qClusters[i].q;
-    qX->Fill(qClusters[i].x, q);
-    qY->Fill(qClusters[i].y, q);
-    qZ->Fill(qClusters[i].z, q);
+    qX.Fill(qClusters[i].x, q);
+    qY.Fill(qClusters[i].y, q);
+    qZ.Fill(qClusters[i].z, q);
   }
-  charge.x_glw = qX->GetStdDev();
-  charge.yw = qY->GetStdDev();
-  charge.zw = qZ->GetStdDev();
+  charge.x_glw = qX.StdDev();
+  charge.yw = qY.StdDev();
+  charge.zw = qZ.StdDev();
 
   // Now fractional widths
   double csize = std::sqrt(charge.x_glw*charge.x_glw + charge.yw*charge.yw + charge.zw*charge.zw);
@@ -802,10 +804,13 @@ FlashPredict::ChargeMetrics FlashPredict::computeChargeMetrics(
 FlashPredict::FlashMetrics FlashPredict::computeFlashMetrics(
   const std::vector<recob::OpHit>& ophits) const
 {
-  std::unique_ptr<TH1F> ophY = std::make_unique<TH1F>("ophY", "", fYBins, fYLow, fYHigh);
-  std::unique_ptr<TH1F> ophZ = std::make_unique<TH1F>("ophZ", "", fZBins, fZLow, fZHigh);
-  std::unique_ptr<TH1F> oph2Y = std::make_unique<TH1F>("oph2Y", "", fYBins, fYLow, fYHigh);
-  std::unique_ptr<TH1F> oph2Z = std::make_unique<TH1F>("oph2Z", "", fZBins, fZLow, fZHigh);
+  // The skewness and kurtosis need the bins; the scratch histograms are
+  // per thread and keep their storage from one call to the next
+  static thread_local sbn::FixedHistogram<float> ophY, ophZ;
+  ophY.Reset(fYBins, fYLow, fYHigh);
+  ophZ.Reset(fZBins, fZLow, fZHigh);
+  sbn::MomentAccumulator oph2Y(fYLow, fYHigh);
+  sbn::MomentAccumulator oph2Z(fZLow, fZHigh);
 
   double peSumMax_wallX = wallXWithMaxPE(ophits);
 
@@ -841,10 +846,10 @@ FlashPredict::FlashMetrics FlashPredict::computeFlashMetrics(
     sum_PE2Y2 += ophPE2 * opDetXYZ.Y() * opDetXYZ.Y();
     sum_PE2Z2 += ophPE2 * opDetXYZ.Z() * opDetXYZ.Z();
 
-    ophY->Fill(opDetXYZ.Y(), ophPE);
-    ophZ->Fill(opDetXYZ.Z(), ophPE);
-    oph2Y->Fill(opDetXYZ.Y(), ophPE2);
-    oph2Z->Fill(opDetXYZ.Z(), ophPE2);
+    ophY.Fill(opDetXYZ.Y(), ophPE);
+    ophZ.Fill(opDetXYZ.Z(), ophPE);
+    oph2Y.Fill(opDetXYZ.Y(), ophPE2);
+    oph2Z.Fill(opDetXYZ.Z(), ophPE2);
 
     if(fICARUS){
       if(std::abs(peSumMax_wallX-opDetXYZ.X()) > 5.) sum_unPE += ophPE;
@@ -861,10 +866,10 @@ FlashPredict::FlashMetrics FlashPredict::computeFlashMetrics(
     flash.metric_ok = true;
     flash.pe    = sum_PE;
     flash.unpe  = sum_unPE;
-    flash.y_skew = ophY->GetSkewness();
-    flash.z_skew = ophZ->GetSkewness();
-    flash.y_kurt = ophY->GetKurtosis();
-    flash.z_kurt = ophZ->GetKurtosis();
+    flash.y_skew = ophY.Skewness();
+    flash.z_skew = ophZ.Skewness();
+    flash.y_kurt = ophY.Kurtosis();
+    flash.z_kurt = ophZ.Kurtosis();
     // Flash widths
     // flash.xw = fractTimeWithFractionOfLight(orig_flash, flash.pe, fFlashPEFraction);
     flash.xw = fractTimeWithFractionOfLight(ophits, sum_PE2, fFlashPEFraction, true);
@@ -874,8 +879,8 @@ FlashPredict::FlashMetrics FlashPredict::computeFlashMetrics(
     // Note that around the middle of the detector (~(+-100, 0, 250)
     // cm for SBND) the values of flash.xw are slightly larger, this
     // is natural and has to do with the way light disperses
-    flash.yw = oph2Y->GetStdDev();
-    flash.zw = oph2Z->GetStdDev();
+    flash.yw = oph2Y.StdDev();
+    flash.zw = oph2Z.StdDev();
 
     flash.ratio = fOpDetNormalizer * flash.unpe / flash.pe;
     if(fSBND && (fFlashType == "simpleflash_ara" || fFlashType == "opflash_ara")) {
@@ -1109,32 +1114,25 @@ FlashPredict::Score FlashPredict::computeScore3D(
   double charge_x = (fCorrectDriftDistance) ?
     driftCorrection(charge.x, flash.time) : charge.x;
 
-  int xb = fRM.dYP3->GetXaxis()->FindBin(charge_x);
-  if (xb < 1) xb = 1;
-  else if (xb > fRM.dYP3->GetXaxis()->GetNbins()) xb = fRM.dYP3->GetXaxis()->GetNbins();
-  int yb = fRM.dYP3->GetYaxis()->FindBin(charge.y);
-  if (yb < 1) yb = 1;
-  else if (yb > fRM.dYP3->GetYaxis()->GetNbins()) yb = fRM.dYP3->GetYaxis()->GetNbins();
-  int zb = fRM.dYP3->GetZaxis()->FindBin(charge.z);
-  if (zb < 1) zb = 1;
-  else if (zb > fRM.dYP3->GetZaxis()->GetNbins()) zb = fRM.dYP3->GetZaxis()->GetNbins();
-
-  score.y = scoreTerm3D(flash.y, charge.y, xb, yb, zb, fRM.dYP3);
+  using sbn::MetricTable3D;
+  const MetricTable3D::Entry* bin = fRM.Metrics3D.Bin(charge_x, charge.y, charge.z);
+
+  score.y = scoreTerm3D(flash.y, charge.y, bin[MetricTable3D::kDY]);
   if(score.y > fTermThreshold) printMetrics("Y", charge, flash, score.y,
                                             mf::LogDebug("FlashPredict"));
   score.total += score.y;
   tcount++;
-  score.z = scoreTerm3D(flash.z, charge.z, xb, yb, zb, fRM.dZP3);
+  score.z = scoreTerm3D(flash.z, charge.z, bin[MetricTable3D::kDZ]);
   if(score.z > fTermThreshold) printMetrics("Z", charge, flash, score.z,
                                             mf::LogDebug("FlashPredict"));
   score.total += score.z;
   tcount++;
-  score.rr = scoreTerm3D(flash.rr, xb, yb, zb, fRM.RRP3);
+  score.rr = scoreTerm3D(flash.rr, bin[MetricTable3D::kRR]);
   if(score.rr > fTermThreshold) printMetrics("RR", charge, flash, score.rr,
                                              mf::LogDebug("FlashPredict"));
   score.total += score.rr;
   tcount++;
-  score.ratio = scoreTerm3D(flash.ratio, xb, yb, zb, fRM.RatioP3);
+  score.ratio = scoreTerm3D(flash.ratio, bin[MetricTable3D::kRatio]);
   if(fICARUS && !std::isnan(flash.h_x)){
     // TODO HACK to penalise matches with flash and charge on opposite volumes
     double charge_x_gl = (fCorrectDriftDistance) ?
@@ -1144,7 +1142,7 @@ FlashPredict::Score FlashPredict::computeScore3D(
     double cathode_tolerance = 30.;
     if(x_gl_diff > x_diff + cathode_tolerance) { // ok if close to the cathode
       double penalization = scoreTerm3D((flash.pe-flash.unpe)/flash.pe,
-                                        xb, yb, zb, fRM.RatioP3);
+                                        bin[MetricTable3D::kRatio]);
       score.ratio += penalization;
       mf::LogInfo("FlashPredict")
         << "HACK: Penalizing match with flash and charge in opposite volumes."
@@ -1159,8 +1157,8 @@ FlashPredict::Score FlashPredict::computeScore3D(
   score.total += score.ratio;
   tcount++;
 
-  // score.slope = scoreTerm3D(flash.slope, charge.slope, xb, yb, zb, fRM.SlopeP3);
-  score.slope = scoreTerm3D(flash.xw, xb, yb, zb, fRM.SlopeP3);
+  // score.slope = scoreTerm3D(flash.slope, charge.slope, bin[MetricTable3D::kSlope]);
+  score.slope = scoreTerm3D(flash.xw, bin[MetricTable3D::kSlope]);
   if(score.slope > fTermThreshold) printMetrics("SLOPE", charge, flash, score.slope,
                                                 mf::LogDebug("FlashPredict"));
   // TODO: if useful add it to the total score
@@ -1168,7 +1166,7 @@ FlashPredict::Score FlashPredict::computeScore3D(
   // tcount++;
   // TODO: if useful add it to the total score
   score.petoq = scoreTerm3D(std::log(flash.pe)/std::log(charge.q),
-                            xb, yb, zb, fRM.PEToQP3);
+                            bin[MetricTable3D::kPEToQ]);
   if(score.petoq > fTermThreshold) printMetrics("LIGHT/CHARGE", charge, flash, score.petoq,
                                                 mf::LogDebug("FlashPredict"));
     score.total += score.petoq;
@@ -1567,23 +1565,18 @@ double FlashPredict::scoreTerm(const double m,
 inline
 double FlashPredict::scoreTerm3D(
   const double m, const double n,
-  const int xb, const int yb, const int zb, const TProfile3D* prof3) const
+  const sbn::MetricTable3D::Entry& entry) const
 {
-  // TODO: these means and spreads should be stored in 3D-arrays
-  // during loadMetrics(), instead of computing them every time. When
-  // that's done, these functions (scoreTerm3D()) should be removed.
-  double mean = prof3->GetBinContent(xb, yb, zb);
-  double spread = prof3->GetBinError(xb, yb, zb);
-  return scoreTerm(m, n, mean, spread);
+  return scoreTerm(m, n, entry.mean, entry.spread);
 }
 
 
 inline
 double FlashPredict::scoreTerm3D(
   const double m,
-  const int xb, const int yb, const int zb, const TProfile3D* prof3) const
+  const sbn::MetricTable3D::Entry& entry) const
 {
-  return scoreTerm3D(m, 0., xb, yb, zb, prof3);
+  return scoreTerm3D(m, 0., entry);
 }
 
 
@@ -1636,30 +1629,24 @@ std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
   std::vector<recob::OpHit>& opHitsRght,
   std::vector<recob::OpHit>& opHitsLeft) const
 {
-  std::unique_ptr<TH1D> opHitsTimeHist = std::make_unique<TH1D>(
-    "opHitsTimeHist", "ophittime", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHist->SetOption("HIST");
-  opHitsTimeHist->SetDirectory(0);//turn off ROOT's object ownership
-  std::unique_ptr<TH1D> opHitsTimeHistRght = std::make_unique<TH1D>(
-    "opHitsTimeHistRght", "ophittimer", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHistRght->SetOption("HIST");
-  opHitsTimeHistRght->SetDirectory(0);//turn off ROOT's object ownership
-  std::unique_ptr<TH1D> opHitsTimeHistLeft = std::make_unique<TH1D>(
-    "opHitsTimeHistLeft", "ophittimel", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHistLeft->SetOption("HIST");
-  opHitsTimeHistLeft->SetDirectory(0);//turn off ROOT's object ownership
+  // Per thread scratch histograms, reused from one event to the next
+  static thread_local sbn::FixedHistogram<double>
+    opHitsTimeHist, opHitsTimeHistRght, opHitsTimeHistLeft;
+  opHitsTimeHist.Reset(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
+  opHitsTimeHistRght.Reset(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
+  opHitsTimeHistLeft.Reset(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
   if(!createOpHitsTimeHist(
        opHits, opHitsRght, opHitsLeft,
        opHitsTimeHist, opHitsTimeHistRght, opHitsTimeHistLeft)) return {};
 
   bool oph_in_rght = false, oph_in_left = false;
   std::vector<FlashPredict::SimpleFlash> simpleFlashes;
-  if(opHitsRght.size() > 0 && opHitsTimeHistRght->GetEntries() > 0){
+  if(opHitsRght.size() > 0 && opHitsTimeHistRght.Entries() > 0){
     oph_in_rght = true;
     findSimpleFlashes(simpleFlashes, opHitsRght,
                       kActivityInRght, opHitsTimeHistRght);
   }
-  if(opHitsLeft.size() > 0 && opHitsTimeHistLeft->GetEntries() > 0){
+  if(opHitsLeft.size() > 0 && opHitsTimeHistLeft.Entries() > 0){
     oph_in_left = true;
     findSimpleFlashes(simpleFlashes, opHitsLeft,
                       kActivityInLeft, opHitsTimeHistLeft);
@@ -1678,10 +1665,9 @@ std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
 std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
   std::vector<recob::OpHit>& opHits) const
 {
-  std::unique_ptr<TH1D> opHitsTimeHist = std::make_unique<TH1D>(
-    "opHitsTimeHist", "ophittime", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHist->SetOption("HIST");
-  opHitsTimeHist->SetDirectory(0);//turn off ROOT's object ownership
+  // Per thread scratch histogram, reused from one event to the next
+  static thread_local sbn::FixedHistogram<double> opHitsTimeHist;
+  opHitsTimeHist.Reset(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
   unsigned ophsInVolume = createOpHitsTimeHist(opHits, opHitsTimeHist);
   if(ophsInVolume == 0) return {};
 
@@ -1697,33 +1683,33 @@ bool FlashPredict::createOpHitsTimeHist(
   const std::vector<recob::OpHit>& opHits,
   std::vector<recob::OpHit>& opHitsRght,
   std::vector<recob::OpHit>& opHitsLeft,
-  std::unique_ptr<TH1D>& opHitsTimeHist,
-  std::unique_ptr<TH1D>& opHitsTimeHistRght,
-  std::unique_ptr<TH1D>& opHitsTimeHistLeft) const
+  sbn::FixedHistogram<double>& opHitsTimeHist,
+  sbn::FixedHistogram<double>& opHitsTimeHistRght,
+  sbn::FixedHistogram<double>& opHitsTimeHistLeft) const
 {
   for(const auto& oph : opHits) {
     auto ch = oph.OpChannel();
-    opHitsTimeHist->Fill(opHitTime(oph), oph.PE());
+    opHitsTimeHist.Fill(opHitTime(oph), oph.PE());
     if(sbndPDinTPC(ch) == kRght){
       opHitsRght.emplace_back(oph);
-      opHitsTimeHistRght->Fill(opHitTime(oph), oph.PE());
+      opHitsTimeHistRght.Fill(opHitTime(oph), oph.PE());
     }
     else{// sbndPDinTPC(ch) == kLeft
       opHitsLeft.emplace_back(oph);
-      opHitsTimeHistLeft->Fill(opHitTime(oph), oph.PE());
+      opHitsTimeHistLeft.Fill(opHitTime(oph), oph.PE());
     }
   }
-  if(opHitsTimeHist->GetEntries() <= 0 ||
-     opHitsTimeHist->Integral() <= 0. ||
-     opHitsTimeHist->Integral() <= fMinFlashPE) return false;
-  if(opHitsTimeHistRght->GetEntries() <= 0 ||
-     opHitsTimeHistRght->Integral() <= 0. ||
-     opHitsTimeHistRght->Integral() <= fMinFlashPE)
-    opHitsTimeHistRght->Reset();
-  if(opHitsTimeHistLeft->GetEntries() <= 0 ||
-     opHitsTimeHistLeft->Integral() <= 0. ||
-     opHitsTimeHistLeft->Integral() <= fMinFlashPE)
-    opHitsTimeHistLeft->Reset();
+  if(opHitsTimeHist.Entries() <= 0 ||
+     opHitsTimeHist.Integral() <= 0. ||
+     opHitsTimeHist.Integral() <= fMinFlashPE) return false;
+  if(opHitsTimeHistRght.Entries() <= 0 ||
+     opHitsTimeHistRght.Integral() <= 0. ||
+     opHitsTimeHistRght.Integral() <= fMinFlashPE)
+    opHitsTimeHistRght.Reset();
+  if(opHitsTimeHistLeft.Entries() <= 0 ||
+     opHitsTimeHistLeft.Integral() <= 0. ||
+     opHitsTimeHistLeft.Integral() <= fMinFlashPE)
+    opHitsTimeHistLeft.Reset();
   return true;
 }
 
@@ -1731,21 +1717,21 @@ bool FlashPredict::createOpHitsTimeHist(
 //ICARUS overload
 unsigned FlashPredict::createOpHitsTimeHist(
   const std::vector<recob::OpHit>& opHits,
-  std::unique_ptr<TH1D>& opHitsTimeHist) const
+  sbn::FixedHistogram<double>& opHitsTimeHist) const
 {
   bool in_right = false, in_left = false;
   for(auto const& oph : opHits) {
     auto ch = oph.OpChannel();
     auto opDetXYZ = fWireReadoutGeom->OpDetGeoFromOpChannel(ch).GetCenter();
     if(!fGeoCryo->ContainsPosition(opDetXYZ)) continue;
-    opHitsTimeHist->Fill(opHitTime(oph), oph.PE());
+    opHitsTimeHist.Fill(opHitTime(oph), oph.PE());
     unsigned t = icarusPDinTPC(ch);
     if(t/fTPCPerDriftVolume == kRght) in_right = true;
     else if(t/fTPCPerDriftVolume == kLeft) in_left = true;
   }
-  if(opHitsTimeHist->GetEntries() <= 0 ||
-     opHitsTimeHist->Integral() <= 0. ||
-     opHitsTimeHist->Integral() <= fMinFlashPE) return 0;
+  if(opHitsTimeHist.Entries() <= 0 ||
+     opHitsTimeHist.Integral() <= 0. ||
+     opHitsTimeHist.Integral() <= fMinFlashPE) return 0;
   if(in_right && in_left) return kActivityInBoth;
   else if(in_right && !in_left) return kActivityInRght;
   else if(!in_right && in_left) return kActivityInLeft;
@@ -1757,28 +1743,26 @@ bool FlashPredict::findSimpleFlashes(
   std::vector<FlashPredict::SimpleFlash>& simpleFlashes,
   std::vector<recob::OpHit>& opHits,
   const unsigned ophsInVolume,
-  std::unique_ptr<TH1D>& opHitsTimeHist) const
+  sbn::FixedHistogram<double>& opHitsTimeHist) const
 {
   OpHitIt opH_beg = opHits.begin();
   for(unsigned flashId=0; flashId<fMaxFlashes; ++flashId){
     double maxpeak_time = std::numeric_limits<double>::min();
     if (flashId < fMinInTimeFlashes) { // First flashes have to be within the beam spill
-      int beam_start_bin = opHitsTimeHist->FindBin(fBeamSpillTimeStart);
-      int beam_end_bin = opHitsTimeHist->FindBin(fBeamSpillTimeEnd);
-      opHitsTimeHist->GetXaxis()->SetRange(beam_start_bin, beam_end_bin);
-      int ibin_beam = opHitsTimeHist->GetMaximumBin();
-      maxpeak_time = opHitsTimeHist->GetBinCenter(ibin_beam);
-      opHitsTimeHist->GetXaxis()->SetRange(0, 0); // reset range
+      int beam_start_bin = opHitsTimeHist.FindBin(fBeamSpillTimeStart);
+      int beam_end_bin = opHitsTimeHist.FindBin(fBeamSpillTimeEnd);
+      int ibin_beam = opHitsTimeHist.MaximumBin(beam_start_bin, beam_end_bin);
+      maxpeak_time = opHitsTimeHist.BinCenter(ibin_beam);
     }
     else {
-      int ibin = opHitsTimeHist->GetMaximumBin();
-      maxpeak_time = opHitsTimeHist->GetBinCenter(ibin);
+      int ibin = opHitsTimeHist.MaximumBin();
+      maxpeak_time = opHitsTimeHist.BinCenter(ibin);
     }
     double lowedge  = maxpeak_time + fFlashStart;
     double highedge = maxpeak_time + fFlashEnd;
-    int lowedge_bin = opHitsTimeHist->FindBin(lowedge);
-    int highedge_bin = opHitsTimeHist->FindBin(highedge);
-    double ophits_integral = opHitsTimeHist->Integral(lowedge_bin, highedge_bin);
+    int lowedge_bin = opHitsTimeHist.FindBin(lowedge);
+    int highedge_bin = opHitsTimeHist.FindBin(highedge);
+    double ophits_integral = opHitsTimeHist.Integral(lowedge_bin, highedge_bin);
     mf::LogDebug("FlashPredict")
       << "Finding Simple Flashes, "
       << "flashId: " << flashId << ",    "
@@ -1789,7 +1773,7 @@ bool FlashPredict::findSimpleFlashes(
       << "[ " << lowedge_bin << ", " << highedge_bin << "] bins";
     // clear this peak to enforce non-overlapping flashes
     for(int i=lowedge_bin; i<highedge_bin; ++i){
-      opHitsTimeHist->SetBinContent(i, 0.);
+      opHitsTimeHist.SetBinContent(i, 0.);
     }
     // check if flash has enough PEs, skip if is the first two flashes
     if (ophits_integral <= fMinFlashPE || ophits_integral <= 0.){
@@ -0,0 +1,98 @@
+#ifndef SBN_FLASHMATCH_METRICTABLE3D_HH
+#define SBN_FLASHMATCH_METRICTABLE3D_HH
+
+// Dense (x, y, z) table of the FlashPredict 3D reference metrics. The mean
+// and spread of every metric in a bin are stored next to each other, so a
+// candidate's score needs one bin lookup and one or two cache lines,
+// instead of a virtual GetBinContent()/GetBinError() pair per metric on
+// each TProfile3D.
+
+#include "TAxis.h"
+#include "TProfile3D.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace sbn {
+
+  class MetricTable3D {
+  public:
+    /// The metrics, in the order of their entries in a bin
+    enum Metric { kDY, kDZ, kRR, kRatio, kSlope, kPEToQ, kNMetrics };
+
+    struct Entry {
+      float mean;
+      float spread;
+    };
+
+    MetricTable3D() = default;
+
+    /// Copy the bin contents and errors of the profiles, one per Metric.
+    /// As before, the bins are those of the first profile, whose axes must
+    /// have fixed bins.
+    explicit MetricTable3D(const std::array<const TProfile3D*, kNMetrics>& profiles)
+    {
+      const TProfile3D* ref = profiles[0];
+      SetAxis(0, ref->GetXaxis());
+      SetAxis(1, ref->GetYaxis());
+      SetAxis(2, ref->GetZaxis());
+
+      fData.resize(std::size_t(fN[0]) * fN[1] * fN[2] * kNMetrics);
+      for (int xb = 1; xb <= fN[0]; ++xb) {
+        for (int yb = 1; yb <= fN[1]; ++yb) {
+          for (int zb = 1; zb <= fN[2]; ++zb) {
+            Entry* bin = &fData[Index(xb, yb, zb)];
+            for (std::size_t m = 0; m < kNMetrics; ++m) {
+              bin[m].mean = profiles[m]->GetBinContent(xb, yb, zb);
+              bin[m].spread = profiles[m]->GetBinError(xb, yb, zb);
+            }
+          }
+        }
+      }
+    }
+
+    /// Entries of all the metrics in the bin of (x, y, z). Points outside
+    /// the table use its closest bin
+    const Entry* Bin(double x, double y, double z) const
+    {
+      return &fData[Index(FindBin(0, x), FindBin(1, y), FindBin(2, z))];
+    }
+
+    /// Bin number along an axis, from 1 to its number of bins
+    int FindBin(int axis, double v) const
+    {
+      // TAxis::FindBin() then clamped, as computeScore3D() used to do
+      int b;
+      if (v < fLow[axis]) b = 0;
+      else if (!(v < fHigh[axis])) b = fN[axis] + 1;
+      else b = 1 + int(fN[axis] * (v - fLow[axis]) / (fHigh[axis] - fLow[axis]));
+      if (b < 1) b = 1;
+      else if (b > fN[axis]) b = fN[axis];
+      return b;
+    }
+
+    bool Empty() const { return fData.empty(); }
+
+  private:
+    void SetAxis(int axis, const TAxis* a)
+    {
+      fN[axis] = a->GetNbins();
+      fLow[axis] = a->GetXmin();
+      fHigh[axis] = a->GetXmax();
+    }
+
+    std::size_t Index(int xb, int yb, int zb) const
+    {
+      return ((std::size_t(xb - 1) * fN[1] + (yb - 1)) * fN[2] + (zb - 1)) * kNMetrics;
+    }
+
+    int fN[3] = {0, 0, 0};
+    double fLow[3] = {0., 0., 0.};
+    double fHigh[3] = {0., 0., 0.};
+    std::vector<Entry> fData; ///< [x][y][z][metric]
+  };
+
+} // namespace sbn
+
+#endif // SBN_FLASHMATCH_METRICTABLE3D_HH
@@ -0,0 +1,150 @@
+// Compares the 3D metric lookups of FlashPredict::computeScore3D() done on
+// the TProfile3D, as they used to be, against sbn::MetricTable3D. Needs
+// ROOT only, so it can run outside of art:
+//
+//   flashpredict_metric_table_bench [candidates] [x bins] [y bins] [z bins]
+
+#include "sbncode/FlashMatch/MetricTable3D.hh"
+
+#include "TProfile3D.h"
+#include "TRandom3.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace {
+
+  struct Candidate {
+    double x, y, z;      // charge barycenter
+    double fy, fz;       // flash barycenter
+    double rr, ratio, slope, petoq;
+  };
+
+  double scoreTerm(double m, double n, double mean, double spread)
+  {
+    return std::abs((m-n) - mean)/spread;
+  }
+
+  int clampedBin(const TAxis* axis, double v)
+  {
+    int b = axis->FindBin(v);
+    if (b < 1) b = 1;
+    else if (b > axis->GetNbins()) b = axis->GetNbins();
+    return b;
+  }
+
+  // What computeScore3D() did before the table
+  double scoreProfiles(const Candidate& c,
+                       const std::array<const TProfile3D*, sbn::MetricTable3D::kNMetrics>& p)
+  {
+    using sbn::MetricTable3D;
+    int xb = clampedBin(p[0]->GetXaxis(), c.x);
+    int yb = clampedBin(p[0]->GetYaxis(), c.y);
+    int zb = clampedBin(p[0]->GetZaxis(), c.z);
+    auto term = [&](double m, double n, int metric) {
+      return scoreTerm(m, n, p[metric]->GetBinContent(xb, yb, zb),
+                       p[metric]->GetBinError(xb, yb, zb));
+    };
+    return term(c.fy, c.y, MetricTable3D::kDY) + term(c.fz, c.z, MetricTable3D::kDZ)
+      + term(c.rr, 0., MetricTable3D::kRR) + term(c.ratio, 0., MetricTable3D::kRatio)
+      + term(c.slope, 0., MetricTable3D::kSlope) + term(c.petoq, 0., MetricTable3D::kPEToQ);
+  }
+
+  double scoreTable(const Candidate& c, const sbn::MetricTable3D& table)
+  {
+    using sbn::MetricTable3D;
+    const MetricTable3D::Entry* bin = table.Bin(c.x, c.y, c.z);
+    auto term = [&](double m, double n, int metric) {
+      return scoreTerm(m, n, bin[metric].mean, bin[metric].spread);
+    };
+    return term(c.fy, c.y, MetricTable3D::kDY) + term(c.fz, c.z, MetricTable3D::kDZ)
+      + term(c.rr, 0., MetricTable3D::kRR) + term(c.ratio, 0., MetricTable3D::kRatio)
+      + term(c.slope, 0., MetricTable3D::kSlope) + term(c.petoq, 0., MetricTable3D::kPEToQ);
+  }
+
+  template <class F>
+  double timeLoop(const std::vector<Candidate>& candidates, std::vector<double>& scores, F score)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < candidates.size(); ++i) scores[i] = score(candidates[i]);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t ncandidates = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  const int nx = (argc > 2) ? std::atoi(argv[2]) : 20;
+  const int ny = (argc > 3) ? std::atoi(argv[3]) : 20;
+  const int nz = (argc > 4) ? std::atoi(argv[4]) : 50;
+
+  // SBND-like active volume
+  const double xlow = -200., xhigh = 200.;
+  const double ylow = -200., yhigh = 200.;
+  const double zlow = 0., zhigh = 500.;
+
+  const char* names[sbn::MetricTable3D::kNMetrics] =
+    {"dy_prof3", "dz_prof3", "rr_prof3", "ratio_prof3", "slope_prof3", "petoq_prof3"};
+  std::vector<std::unique_ptr<TProfile3D>> owned;
+  std::array<const TProfile3D*, sbn::MetricTable3D::kNMetrics> profiles;
+  TRandom3 rnd(12345);
+  for (int m = 0; m < sbn::MetricTable3D::kNMetrics; ++m) {
+    owned.emplace_back(new TProfile3D(names[m], names[m], nx, xlow, xhigh,
+                                      ny, ylow, yhigh, nz, zlow, zhigh));
+    owned.back()->SetDirectory(nullptr);
+    for (int i = 0; i < 20*nx*ny*nz; ++i) {
+      owned.back()->Fill(rnd.Uniform(xlow, xhigh), rnd.Uniform(ylow, yhigh),
+                         rnd.Uniform(zlow, zhigh), rnd.Gaus(m, 1. + m));
+    }
+    profiles[m] = owned.back().get();
+  }
+
+  auto buildStart = std::chrono::steady_clock::now();
+  sbn::MetricTable3D table(profiles);
+  std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - buildStart;
+
+  // Some candidates fall outside of the profiles, to exercise the clamping
+  std::vector<Candidate> candidates(ncandidates);
+  for (Candidate& c : candidates) {
+    c = {rnd.Uniform(xlow - 20., xhigh + 20.), rnd.Uniform(ylow - 20., yhigh + 20.),
+         rnd.Uniform(zlow - 20., zhigh + 20.), rnd.Uniform(ylow, yhigh),
+         rnd.Uniform(zlow, zhigh), rnd.Uniform(0., 100.), rnd.Uniform(0., 1.),
+         rnd.Uniform(-1., 1.), rnd.Uniform(0., 3.)};
+  }
+
+  std::vector<double> oldScores(ncandidates), newScores(ncandidates);
+  const double oldTime = timeLoop(candidates, oldScores,
+                                  [&](const Candidate& c) { return scoreProfiles(c, profiles); });
+  const double newTime = timeLoop(candidates, newScores,
+                                  [&](const Candidate& c) { return scoreTable(c, table); });
+
+  // The table stores floats, so scores agree to float precision
+  double maxRelDiff = 0.;
+  std::size_t nBad = 0;
+  for (std::size_t i = 0; i < ncandidates; ++i) {
+    // bins with a single entry have no spread
+    if (!std::isfinite(oldScores[i]) && !std::isfinite(newScores[i])) continue;
+    double diff = std::abs(oldScores[i] - newScores[i]);
+    double rel = diff/std::max(std::abs(oldScores[i]), 1.);
+    maxRelDiff = std::max(maxRelDiff, rel);
+    if (!(rel < 1e-5)) ++nBad;
+  }
+
+  std::cout << "Bins: " << nx << " x " << ny << " x " << nz
+            << ", table built in " << buildTime.count()*1e3 << " ms\n"
+            << "TProfile3D: " << ncandidates/oldTime*1e-6 << " M candidates/s\n"
+            << "Table:      " << ncandidates/newTime*1e-6 << " M candidates/s"
+            << " (x" << oldTime/newTime << ")\n"
+            << "Largest relative difference: " << maxRelDiff
+            << ", candidates off by more than 1e-5: " << nBad << std::endl;
+
+  return (nBad == 0) ? 0 : 1;
+}
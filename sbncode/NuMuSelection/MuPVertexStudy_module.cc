@@ -49,7 +49,7 @@
 #include "nusimdata/SimulationBase/MCParticle.h"
 #include "nusimdata/SimulationBase/MCTruth.h"
 
-#include "larcorealg/GeoAlgo/GeoAlgo.h"
+#include "sbncode/OpT0Finder/flashmatch/GeoAlgo/GeoSlab.h"
 
 #include "TH1D.h"
 #include "sbncode/CAFMaker/RecoUtils/RecoUtils.h"
@@ -80,9 +80,6 @@ struct TrueHistos {
 
 float Completion(const simb::MCParticle &particle, float particleE, const std::vector<std::pair<int, float>> &matches, const std::vector<simb::MCParticle> &particles);
 float Purity(const simb::MCParticle &particle, float totalE, const std::vector<std::pair<int, float>> &matches, const std::vector<simb::MCParticle> &particles);
-float ContainedLength(const TVector3 &v0, const TVector3 &v1,
-                      const std::vector<geoalgo::AABox> &boxes);
-
 class numu::MuPVertexStudy : public art::EDAnalyzer {
 public:
   explicit MuPVertexStudy(fhicl::ParameterSet const& p);
@@ -185,7 +182,7 @@ numu::MuPVertexStudy::MuPVertexStudy(fhicl::ParameterSet const& p)
 }
 
 float numu::MuPVertexStudy::ParticleLength(const simb::MCParticle &particle) {
-  std::vector<geoalgo::AABox> aa_volumes;
+  std::vector<geoalgo::SlabBox> aa_volumes;
   for (const geo::BoxBoundedGeo &AV: fActiveVolumes) {
     if (AV.ContainsPosition(particle.Position().Vect())) {
       aa_volumes.emplace_back(AV.MinX(), AV.MinY(), AV.MinZ(), AV.MaxX(), AV.MaxY(), AV.MaxZ());
@@ -193,12 +190,16 @@ float numu::MuPVertexStudy::ParticleLength(const simb::MCParticle &particle) {
     }
   }
 
-  float length = 0.;
+  // all the trajectory steps go through the boxes in one pass
+  geoalgo::SegmentArray steps;
+  steps.reserve(particle.NumberTrajectoryPoints());
   for (unsigned i = 1; i < particle.NumberTrajectoryPoints(); i++) {
-    length += ContainedLength(particle.Position(i-1).Vect(), particle.Position(i).Vect(), aa_volumes);
+    const TLorentzVector &p0 = particle.Position(i-1);
+    const TLorentzVector &p1 = particle.Position(i);
+    steps.push_back(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
   }
 
-  return length;
+  return geoalgo::ContainedLength(steps, aa_volumes);
 }
 
 void numu::MuPVertexStudy::FillTrue(const simb::MCParticle &muon, const simb::MCParticle &proton) {
@@ -345,111 +346,4 @@ float Purity(const simb::MCParticle &particle, float totalE, const std::vector<s
   return matchE / totalE;
 }
 
-float ContainedLength(const TVector3 &v0, const TVector3 &v1,
-                       const std::vector<geoalgo::AABox> &boxes) {
-  static const geoalgo::GeoAlgo algo;
-
-  // if points are the same, return 0
-  if ((v0 - v1).Mag() < 1e-6) return 0;
-
-  // construct individual points
-  geoalgo::Point_t p0(v0);
-  geoalgo::Point_t p1(v1);
-
-  // construct line segment
-  geoalgo::LineSegment line(p0, p1);
-
-  double length = 0;
-
-  // total contained length is sum of lengths in all boxes
-  // assuming they are non-overlapping
-  for (auto const &box: boxes) {
-    int n_contained = box.Contain(p0) + box.Contain(p1);
-    // both points contained -- length is total length (also can break out of loop)
-    if (n_contained == 2) {
-      length = (v1 - v0).Mag();
-      break;
-    }
-    // one contained -- have to find intersection point (which must exist)
-    if (n_contained == 1) {
-      auto intersections = algo.Intersection(line, box);
-      // Because of floating point errors, it can sometimes happen
-      // that there is 1 contained point but no "Intersections"
-      // if one of the points is right on the edge
-      if (intersections.size() == 0) {
-        // determine which point is on the edge
-        double tol = 1e-5;
-        bool p0_edge = algo.SqDist(p0, box) < tol;
-        bool p1_edge = algo.SqDist(p1, box) < tol;
-        assert(p0_edge || p1_edge);
-        // contained one is on edge -- can treat both as not contained
-        //
-        // In this case, no length
-        if ((p0_edge && box.Contain(p0)) || (box.Contain(p1) && p1_edge))
-          continue;
-        // un-contaned one is on edge -- treat both as contained
-        else if ((p0_edge && box.Contain(p1)) || (box.Contain(p0) && p1_edge)) {
-	  length = (v1 - v0).Mag();
-	  break;
-        }
-        else {
-          assert(false); // bad
-        }
-      }
-      // floating point errors can also falsely cause 2 intersection points
-      //
-      // in this case, one of the intersections must be very close to the 
-      // "contained" point, so the total contained length will be about
-      // the same as the distance between the two intersection points
-      else if (intersections.size() == 2) {
-        length += (intersections.at(0).ToTLorentzVector().Vect() - intersections.at(1).ToTLorentzVector().Vect()).Mag();
-        continue;
-      }
-      // "Correct"/ideal case -- 1 intersection point
-      else if (intersections.size() == 1) {
-        // get TVector at intersection point
-        TVector3 int_tv(intersections.at(0).ToTLorentzVector().Vect());
-        length += ( box.Contain(p0) ? (v0 - int_tv).Mag() : (v1 - int_tv).Mag() ); 
-      }
-      else assert(false); // bad
-    }
-    // none contained -- either must have zero or two intersections
-    if (n_contained == 0) {
-      auto intersections = algo.Intersection(line, box);
-      if (!(intersections.size() == 0 || intersections.size() == 2)) {
-        // more floating point error fixes...
-        //
-        // figure out which points are near the edge
-        double tol = 1e-5;
-        bool p0_edge = algo.SqDist(p0, box) < tol;
-        bool p1_edge = algo.SqDist(p1, box) < tol;
-        // and which points are near the intersection
-        TVector3 vint = intersections.at(0).ToTLorentzVector().Vect();
-
-        bool p0_int = (v0 - vint).Mag() < tol;
-        bool p1_int = (v1 - vint).Mag() < tol;
-        // exactly one of them should produce the intersection
-        assert((p0_int && p0_edge) != (p1_int && p1_edge));
-        // void variables when assert-ions are turned off
-        (void) p0_int; (void) p1_int;
-
-        // both close to edge -- full length is contained
-        if (p0_edge && p1_edge) {
-          length += (v0 - v1).Mag();
-        }
-        // otherwise -- one of them is not on an edge, no length is contained
-        else {}
-      }
-      // assert(intersections.size() == 0 || intersections.size() == 2);
-      else if (intersections.size() == 2) {
-        TVector3 start(intersections.at(0).ToTLorentzVector().Vect());
-        TVector3 end(intersections.at(1).ToTLorentzVector().Vect());
-        length += (start - end).Mag();
-      }
-    }
-  }
-
-  return length;
-}//ContainedLength
-
 DEFINE_ART_MODULE(numu::MuPVertexStudy)
@@ -15,11 +15,34 @@ namespace flashmatch {
 
   static PhotonLibHypothesisFactory __global_PhotonLibHypothesisFactory__;
 
+  /// With interpolation, PhotonVisibilityService::GetAllVisibilities returns
+  /// one buffer shared by all its callers, and the library is loaded on the
+  /// first call. Rows are therefore fetched and copied one thread at a time
+  static std::mutex __photon_vis_mutex__;
+
   PhotonLibHypothesis::PhotonLibHypothesis(const std::string name)
     : BaseFlashHypothesis(name)
     , _vis(art::ServiceHandle<phot::PhotonVisibilityService const>().get())
   {}
 
+  PhotonLibHypothesis::~PhotonLibHypothesis()
+  {
+    #if USING_LARSOFT == 1
+    auto const& c = _semi_cache;
+    if (c.pitch > 0) {
+      FLASH_NORMAL() << "Semi-analytical visibility cache: " << c.nodes.size() << " nodes of "
+                     << c.pitch << " cm, " << c.n_exact << " points computed exactly" << std::endl;
+    }
+    if (c.pitch > 0 && c.validate && c.n_compared > 0) {
+      FLASH_NORMAL() << "Semi-analytical visibility cache validation over " << c.n_compared
+                     << " visibilities: mean |error| " << c.sum_abs_err / c.n_compared
+                     << ", max |error| " << c.max_abs_err
+                     << ", relative to the summed exact visibility "
+                     << (c.sum_exact > 0 ? c.sum_abs_err / c.sum_exact : 0.) << std::endl;
+    }
+    #endif
+  }
+
   void PhotonLibHypothesis::_Configure_(const Config_t &pset)
   {
     #if USING_LARSOFT == 0
@@ -30,6 +53,30 @@ namespace flashmatch {
     _global_qe_refl = pset.get<double>("GlobalQERefl", 0);
     _use_semi_analytical = pset.get<bool>("UseSemiAnalytical", 0);
 
+    #if USING_LARSOFT == 1
+    // Optional cache of the semi-analytical visibilities on a grid spanning
+    // the active volume. The position alone fixes the visibilities, so the
+    // grid is detector-wide rather than per TPC
+    {
+      auto& c = _semi_cache;
+      std::lock_guard<std::shared_mutex> lock(c.mutex);
+      c.nodes.clear();
+      c.pitch = pset.get<double>("SemiAnalyticalCachePitch", 0.);
+      c.validate = pset.get<bool>("SemiAnalyticalCacheValidate", false);
+      c.n_opdet = DetectorSpecs::GetME().NOpDets();
+      const double max_mb = pset.get<double>("SemiAnalyticalCacheMaxMB", 512.);
+      c.max_nodes = c.n_opdet ? (size_t)(max_mb * 1024. * 1024. / (2 * c.n_opdet * sizeof(float))) : 0;
+      if (c.pitch > 0) {
+        auto const& av = DetectorSpecs::GetME().ActiveVolume();
+        for (size_t a = 0; a < 3; ++a) {
+          c.min[a] = av.Min()[a];
+          // Last node at or beyond the upper edge
+          c.n[a] = (long)std::ceil((av.Max()[a] - av.Min()[a]) / c.pitch) + 1;
+        }
+      }
+    }
+    #endif
+
     _qe_v.clear();
     _qe_refl_v.clear();
     _qe_v = pset.get<std::vector<double> >("VUVEfficiency",_qe_v);
@@ -77,6 +124,9 @@ namespace flashmatch {
 
   void PhotonLibHypothesis::FillEstimateSemiAnalytical(const QCluster_t& trk, Flash_t &flash) const
   {
+    std::vector<double> direct_visibilities;
+    std::vector<double> reflected_visibilities;
+
     for ( size_t ipt = 0; ipt < trk.size(); ++ipt) {
 
       /// Get the 3D point in space from where photons should be propagated
@@ -86,11 +136,7 @@ namespace flashmatch {
 
       double n_original_photons = pt.q;
 
-      std::vector<double> direct_visibilities;
-      _semi_model->detectedDirectVisibilities(direct_visibilities, xyz);
-
-      std::vector<double> reflected_visibilities;
-      _semi_model->detectedReflectedVisibilities(reflected_visibilities, xyz);
+      SemiAnalyticalVisibilities(xyz, direct_visibilities, reflected_visibilities);
 
       //
       // Fill Estimate with Direct light
@@ -135,48 +181,187 @@ namespace flashmatch {
 
 
 
-  void PhotonLibHypothesis::FillEstimateLibrary(const QCluster_t& trk, Flash_t &flash) const
+  void PhotonLibHypothesis::SemiAnalyticalVisibilities(geo::Point_t const& xyz,
+                                                       std::vector<double>& direct,
+                                                       std::vector<double>& reflected) const
   {
+    auto& c = _semi_cache;
+
+    if (c.pitch > 0) {
+      if (InterpolateSemiAnalytical(xyz, direct, reflected)) {
+        if (!c.validate) return;
+
+        // Compare to the exact model, but keep using the interpolation so
+        // the job behaves as it would without validation
+        std::vector<double> exact_direct, exact_reflected;
+        _semi_model->detectedDirectVisibilities(exact_direct, xyz);
+        _semi_model->detectedReflectedVisibilities(exact_reflected, xyz);
+
+        double sum_abs_err = 0., max_abs_err = 0., sum_exact = 0.;
+        for (size_t i = 0; i < exact_direct.size() && i < direct.size(); ++i) {
+          const double err = std::abs(direct[i] - exact_direct[i]);
+          sum_abs_err += err;
+          max_abs_err = std::max(max_abs_err, err);
+          sum_exact += std::abs(exact_direct[i]);
+        }
+        for (size_t i = 0; i < exact_reflected.size() && i < reflected.size(); ++i) {
+          const double err = std::abs(reflected[i] - exact_reflected[i]);
+          sum_abs_err += err;
+          max_abs_err = std::max(max_abs_err, err);
+          sum_exact += std::abs(exact_reflected[i]);
+        }
 
-    static double xyz[3] = {0.};
+        std::lock_guard<std::shared_mutex> lock(c.mutex);
+        c.n_compared += exact_direct.size() + exact_reflected.size();
+        c.sum_abs_err += sum_abs_err;
+        c.max_abs_err = std::max(c.max_abs_err, max_abs_err);
+        c.sum_exact += sum_exact;
+        return;
+      }
 
-    size_t n_pmt = DetectorSpecs::GetME().NOpDets();
+      std::lock_guard<std::shared_mutex> lock(c.mutex);
+      ++c.n_exact;
+    }
+
+    _semi_model->detectedDirectVisibilities(direct, xyz);
+    _semi_model->detectedReflectedVisibilities(reflected, xyz);
+  }
 
-    for ( size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
 
-      if (std::find(_channel_mask.begin(), _channel_mask.end(), ipmt) == _channel_mask.end()) {
-        continue;
+  bool PhotonLibHypothesis::InterpolateSemiAnalytical(geo::Point_t const& xyz,
+                                                      std::vector<double>& direct,
+                                                      std::vector<double>& reflected) const
+  {
+    auto& c = _semi_cache;
+    const size_t n_opdet = c.n_opdet;
+
+    // Cell containing xyz, and the position inside it
+    const double pos[3] = {xyz.X(), xyz.Y(), xyz.Z()};
+    long i0[3];
+    double f[3];
+    for (size_t a = 0; a < 3; ++a) {
+      const double u = (pos[a] - c.min[a]) / c.pitch;
+      if (!(u >= 0.)) return false;
+      i0[a] = (long)u;
+      if (i0[a] + 1 >= c.n[a]) return false;
+      f[a] = u - i0[a];
+    }
+
+    // Its 8 corner nodes; bit a of k set for the upper node along axis a
+    int64_t key[8];
+    const float* corner[8];
+    for (size_t k = 0; k < 8; ++k) {
+      key[k] = ((int64_t)(i0[0] + (k & 1)) * c.n[1] + (i0[1] + ((k >> 1) & 1))) * c.n[2]
+        + (i0[2] + ((k >> 2) & 1));
+    }
+    {
+      std::shared_lock<std::shared_mutex> lock(c.mutex);
+      for (size_t k = 0; k < 8; ++k) {
+        auto it = c.nodes.find(key[k]);
+        corner[k] = (it == c.nodes.end()) ? nullptr : it->second.get();
       }
+    }
 
-      bool is_uncoated = false;
-      if (std::find(_uncoated_pmt_list.begin(), _uncoated_pmt_list.end(), ipmt) != _uncoated_pmt_list.end()) {
-        is_uncoated = true;
+    // Compute the missing nodes outside the lock. If two threads compute the
+    // same node the first one stored is kept
+    std::vector<double> node_direct, node_reflected;
+    for (size_t k = 0; k < 8; ++k) {
+      if (corner[k]) continue;
+      {
+        std::shared_lock<std::shared_mutex> lock(c.mutex);
+        if (c.nodes.size() >= c.max_nodes) return false;
       }
 
-      for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
-        auto const& pt = trk[ipt];
+      geo::Point_t const node = {c.min[0] + (i0[0] + (k & 1)) * c.pitch,
+                                 c.min[1] + (i0[1] + ((k >> 1) & 1)) * c.pitch,
+                                 c.min[2] + (i0[2] + ((k >> 2) & 1)) * c.pitch};
+      _semi_model->detectedDirectVisibilities(node_direct, node);
+      _semi_model->detectedReflectedVisibilities(node_reflected, node);
+      if (node_direct.size() != n_opdet || node_reflected.size() != n_opdet) return false;
+
+      std::unique_ptr<float[]> data(new float[2 * n_opdet]);
+      for (size_t i = 0; i < n_opdet; ++i) {
+        data[i] = node_direct[i];
+        data[n_opdet + i] = node_reflected[i];
+      }
 
-        double q = pt.q;
+      std::lock_guard<std::shared_mutex> lock(c.mutex);
+      corner[k] = c.nodes.emplace(key[k], std::move(data)).first->second.get();
+    }
 
-        xyz[0] = pt.x;
-        xyz[1] = pt.y;
-        xyz[2] = pt.z;
+    // Trilinear interpolation
+    direct.assign(n_opdet, 0.);
+    reflected.assign(n_opdet, 0.);
+    for (size_t k = 0; k < 8; ++k) {
+      const double w = ((k & 1) ? f[0] : 1. - f[0])
+        * (((k >> 1) & 1) ? f[1] : 1. - f[1])
+        * (((k >> 2) & 1) ? f[2] : 1. - f[2]);
+      const float* data = corner[k];
+      for (size_t i = 0; i < n_opdet; ++i) {
+        direct[i] += w * data[i];
+        reflected[i] += w * data[n_opdet + i];
+      }
+    }
+    return true;
+  }
 
-        double q_direct = 0, q_refl = 0;
 
-        // Direct light
-        if (is_uncoated) {
-          q_direct = 0;
-        } else {
-          q_direct = q * _vis->GetVisibility(xyz, ipmt) * _global_qe * _qe_v[ipmt];
-        }
-        // std::cout << "PMT : " << ipmt << " [x,y,z] -> [q] : [" << pt.x << ", " << pt.y << ", " << pt.z << "] -> [" << q << "]" << std::endl;
+  void PhotonLibHypothesis::FillEstimateLibrary(const QCluster_t& trk, Flash_t &flash) const
+  {
+    size_t n_pmt = DetectorSpecs::GetME().NOpDets();
 
-        // Reflected light
-        q_refl = q * _vis->GetVisibility(xyz, ipmt, true) * _global_qe_refl * _qe_refl_v[ipmt];
+    // Relative QE of each PMT, set to zero for the channels not in the mask
+    // (and, for direct light, for the uncoated PMTs), so the per-point loops
+    // below run over all the PMTs without branches or lookups
+    std::vector<double> qe_direct(n_pmt, 0.), qe_refl(n_pmt, 0.);
+    for (int ch : _channel_mask) {
+      if (ch < 0 || (size_t)ch >= n_pmt) continue;
+      qe_direct[ch] = _qe_v[ch];
+      qe_refl[ch] = _qe_refl_v[ch];
+    }
+    for (int ch : _uncoated_pmt_list) {
+      if (ch >= 0 && (size_t)ch < n_pmt) qe_direct[ch] = 0.;
+    }
 
-        flash.pe_v[ipmt] += q_direct;
-        flash.pe_v[ipmt] += q_refl;
+    // Reflected light adds exactly zero without a reflected QE
+    const bool use_refl = _global_qe_refl != 0.;
+
+    std::vector<float> vis_v(n_pmt);
+
+    for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
+      auto const& pt = trk[ipt];
+
+      geo::Point_t const xyz = {pt.x, pt.y, pt.z};
+
+      // Points outside the library have zero visibility. VoxelAt maps the
+      // detector position into the library first, as GetVisibility does
+      if (_vis->VoxelAt(xyz) < 0) continue;
+
+      double q = pt.q;
+
+      // One voxel lookup per point, then all the PMTs at once. The terms are
+      // added to each PMT in the same order as one point at a time per PMT,
+      // direct light first, so the sums are unchanged
+
+      // Direct light
+      {
+        std::lock_guard<std::mutex> lock(__photon_vis_mutex__);
+        auto const vis_direct = _vis->GetAllVisibilities(xyz);
+        for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) vis_v[ipmt] = vis_direct[ipmt];
+      }
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+        flash.pe_v[ipmt] += q * vis_v[ipmt] * _global_qe * qe_direct[ipmt];
+      }
+
+      // Reflected light
+      if (!use_refl) continue;
+      {
+        std::lock_guard<std::mutex> lock(__photon_vis_mutex__);
+        auto const vis_refl = _vis->GetAllVisibilities(xyz, true);
+        for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) vis_v[ipmt] = vis_refl[ipmt];
+      }
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+        flash.pe_v[ipmt] += q * vis_v[ipmt] * _global_qe_refl * qe_refl[ipmt];
       }
     }
     return;
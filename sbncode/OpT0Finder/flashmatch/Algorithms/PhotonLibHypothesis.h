@@ -31,9 +31,16 @@
 #include "sbncode/OpT0Finder/flashmatch/Base/FlashHypothesisFactory.h"
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace flashmatch {
   /**
@@ -48,7 +55,7 @@ namespace flashmatch {
     PhotonLibHypothesis(const std::string name="PhotonLibHypothesis");
 
     /// Default destructor
-    virtual ~PhotonLibHypothesis(){}
+    virtual ~PhotonLibHypothesis();
 
     void FillEstimate(const QCluster_t&, Flash_t&) const;
 
@@ -59,6 +66,48 @@ namespace flashmatch {
     /// Fills the estimate using the photon library (ICARUS, SBND)
     void FillEstimateLibrary(const QCluster_t&, Flash_t &) const;
 
+    #if USING_LARSOFT == 1
+    /// Semi-analytical direct and reflected visibilities at xyz, interpolated
+    /// from the cache when it is enabled
+    void SemiAnalyticalVisibilities(geo::Point_t const& xyz,
+                                    std::vector<double>& direct,
+                                    std::vector<double>& reflected) const;
+
+    /// Interpolate from the cache. Returns false if xyz is outside the grid
+    /// or the cache is full, in which case the caller uses the exact model
+    bool InterpolateSemiAnalytical(geo::Point_t const& xyz,
+                                   std::vector<double>& direct,
+                                   std::vector<double>& reflected) const;
+
+    /// \brief Lazily filled grid of semi-analytical visibilities
+    ///
+    /// Nodes are spaced by a fixed pitch over the detector active volume and
+    /// hold the direct and reflected visibilities of every opdet (as float).
+    /// A node is computed the first time a point in one of its cells is
+    /// needed, and kept for the rest of the job. Nodes are never removed, so
+    /// their data stay put while other threads add more. Threads look nodes
+    /// up together, and only adding a node excludes the others.
+    struct SemiAnalyticalCache {
+      double pitch = 0;             ///< Grid pitch [cm], 0 disables the cache
+      size_t max_nodes = 0;         ///< Memory cap, in nodes
+      bool   validate = false;      ///< Also run the exact model and compare
+      double min[3] = {0., 0., 0.}; ///< Position of node (0,0,0)
+      long   n[3] = {0, 0, 0};      ///< Number of nodes along each axis
+      size_t n_opdet = 0;           ///< Visibilities per node and light type
+
+      std::shared_mutex mutex;
+      std::unordered_map<int64_t, std::unique_ptr<float[]>> nodes; ///< direct then reflected
+
+      // Validation: interpolated - exact visibility, over all opdets
+      size_t n_compared = 0;
+      double sum_abs_err = 0.;
+      double max_abs_err = 0.;
+      double sum_exact = 0.;
+      size_t n_exact = 0;           ///< Points that fell back to the exact model
+    };
+    mutable SemiAnalyticalCache _semi_cache;
+    #endif
+
   protected:
 
     void _Configure_(const Config_t &pset);
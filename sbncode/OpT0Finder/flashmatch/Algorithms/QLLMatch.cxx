@@ -10,15 +10,73 @@ namespace flashmatch {
 
   QLLMatch *QLLMatch::_me = nullptr;
 
+  /// Instance being fit by Minuit in this thread, for MIN_vtx_qll
+  static thread_local QLLMatch* __qll_fit_instance__ = nullptr;
+
+  /// TMinuit keeps global state (gMinuit), so fits are run one at a time,
+  /// including the FillEstimate calls made from MIN_vtx_qll
+  static std::mutex __qll_minuit_mutex__;
+
   void MIN_vtx_qll(Int_t &, Double_t *, Double_t &, Double_t *, Int_t);
 
   QLLMatch::QLLMatch(const std::string name)
     : BaseFlashMatch(name), _mode(kChi2), _record(false), _normalize(false), _minuit_ptr(nullptr)
+    , _construct_hypo_count(0), _hypo_grid_step(0), _hypo_grid_scan(false), _hypo_grid_npts(0)
   { _current_llhd = _current_chi2 = -1.0; }
 
   QLLMatch::QLLMatch()
   { throw OpT0FinderException("Use QLLMatch::GetME() to obtain singleton pointer!"); }
 
+  BaseFlashMatch* QLLMatch::Clone() const
+  {
+    QLLMatch* copy = new QLLMatch(*this);
+    copy->_minuit_ptr = nullptr;
+    return copy;
+  }
+
+  double QLLMatch::ScoreBound(const QCluster_t &pt_v, const Flash_t &flash) const
+  {
+    const double no_bound = std::numeric_limits<double>::max();
+
+    // The normalisation depends on the hypothesis, and the chi2 can reach 0
+    if (_normalize || _mode == kChi2) return no_bound;
+
+    // Each channel term of QLL() is smallest for H = O, whatever the
+    // hypothesis and the x offset. Sum those minima over the channels QLL()
+    // would use for this pair
+    double qll_min = 0.;
+    double nvalid_ch = 0;
+    for (size_t ich = 0; ich < flash.pe_v.size(); ++ich) {
+      if ( int(ich)%2 != _tpc%2) continue;
+      if (flash.pds_mask_v.at(ich) != 0 || pt_v.tpc_mask_v.at(ich) != 0) continue;
+
+      double O = flash.pe_v[ich];
+      if (O < _pe_observation_threshold) {
+        O = (_penalty_value_v.empty() ? _pe_observation_threshold : _penalty_value_v[ich]);
+      }
+
+      if (_mode == kLLHD) {
+        // -log10 of the Poisson probability of O for a mean of O
+        double term = (O > 0 ? -(O*std::log(O) - O - std::lgamma(O+1.)) / std::log(10.) : 0.);
+        // Stirling's approximation, used when Gamma overflows, is lower by up to 1/(12 O ln10)
+        if (O > 100.) term -= 1. / (12. * O * std::log(10.));
+        if (term < 0) return no_bound;
+        qll_min += term;
+        nvalid_ch += 1;
+      }
+      else {
+        qll_min += (O > 0 ? O - O * std::log(O) : 0.);
+      }
+    }
+
+    // Same conversions as QLL() and PESpectrumMatch(), with a margin for rounding
+    if (_mode == kLLHD) {
+      qll_min /= (nvalid_ch + 1);
+      return (qll_min > 0 ? (1. / qll_min) * (1. + 1.e-9) : no_bound);
+    }
+    return -qll_min + 1.e-9 * std::abs(qll_min);
+  }
+
   void QLLMatch::_Configure_(const Config_t &pset) {
     _record = pset.get<bool>("RecordHistory");
     _normalize = pset.get<bool>("NormalizeFlash");
@@ -32,6 +90,12 @@ namespace flashmatch {
     _pe_observation_threshold = pset.get<double>("PEObservationThreshold", 1.e-6);
     _pe_hypothesis_threshold  = pset.get<double>("PEHypothesisThreshold", 1.e-6);
     _migrad_tolerance         = pset.get<double>("MIGRADTolerance", 0.1);
+    _hypo_grid_step           = pset.get<double>("HypothesisGridStep", 0.);
+    _hypo_grid_scan           = pset.get<bool>("HypothesisGridScan", false);
+    if (_hypo_grid_step > 0 && !_use_minuit)
+      throw OpT0FinderException("HypothesisGridStep > 0 requires UseMinuit: true (the grid is only used by the x offset fit)");
+    _hypo_grid_npts = 0;
+    _hypo_grid_pe_v.clear();
 
     this->set_verbosity((msg::Level_t)(pset.get<unsigned int>("Verbosity", 3)));
 
@@ -88,6 +152,7 @@ namespace flashmatch {
   FlashMatch_t QLLMatch::Match(const QCluster_t &pt_v, const Flash_t &flash) {
 
     _construct_hypo_time = 0;
+    _construct_hypo_count = 0;
 
     // combine cluster + flash mask for this match pair 
     _match_mask.clear();
@@ -115,11 +180,19 @@ namespace flashmatch {
     FlashMatch_t res; 
     if (_use_minuit){
       for (auto &pt : _raw_trk) pt.x -= min_x;
+      if (_hypo_grid_step > 0) FillHypothesisGrid();
+      if (_hypo_grid_step > 0 && _hypo_grid_scan) {
+        // The scan does not depend on the starting point
+        res = PESpectrumMatch(pt_v,flash,true);
+        FLASH_INFO() << "Grid scan ... maximized 1/param Score=" << res.score << " @ X=" << res.tpc_point.x << " [cm]" << std::endl;
+      }
+      else {
       auto res1 = PESpectrumMatch(pt_v,flash,true);
       auto res2 = PESpectrumMatch(pt_v,flash,false);
       FLASH_INFO() << "Using   mid-x-init ... maximized 1/param Score=" << res1.score << " @ X=" << res1.tpc_point.x << " [cm]" << std::endl;
       FLASH_INFO() << "Without mid-x-init ... maximized 1/param Score=" << res2.score << " @ X=" << res2.tpc_point.x << " [cm]" << std::endl;
       res = (res1.score > res2.score ? res1 : res2);
+      }
 
       /*
       if(res.score < _onepmt_score_threshold) {
@@ -135,7 +208,8 @@ namespace flashmatch {
     else{
       res = OnePMTSpectrumMatch(flash);
     }
-    FLASH_INFO() << "Time spent constructing hypotheses: " << _construct_hypo_time << " ns." << std::endl;
+    FLASH_INFO() << "Time spent constructing hypotheses: " << _construct_hypo_time << " ns ("
+                 << _construct_hypo_count << " FillEstimate calls)." << std::endl;
     return res;
   }
   
@@ -193,7 +267,7 @@ namespace flashmatch {
     }
 
     // perform likelihood calculation
-    _qll = QLLMatch::GetME()->QLL(one_hypothesis, one_measurement);
+    _qll = QLL(one_hypothesis, one_measurement);
     if (std::isnan(_qll) || std::isinf(_qll)) {
       return res;
     }
@@ -343,16 +417,25 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
 
     for (auto &v : _hypothesis.pe_v) v = 0;
 
-    // Apply xoffset
-    _var_trk.resize(_raw_trk.size());
-    for (size_t pt_index = 0; pt_index < _raw_trk.size(); ++pt_index) {
-      //std::cout << "x point : " << _raw_trk[pt_index].x << "\t offset : " << xoffset << std::endl;
-      _var_trk[pt_index].x = _raw_trk[pt_index].x + xoffset;
-      _var_trk[pt_index].y = _raw_trk[pt_index].y;
-      _var_trk[pt_index].z = _raw_trk[pt_index].z;
-      _var_trk[pt_index].q = _raw_trk[pt_index].q;
-      if (_raw_trk[pt_index].q > 1e20) std::cout << "[QLLMatch::ChargeHypothesis] n_original_photons " << _raw_trk[pt_index].q << std::endl;
+    if (_hypo_grid_step > 0 && _hypo_grid_npts) {
+      // Linear interpolation between the two nearest grid hypotheses
+      const size_t nopdet = _hypothesis.pe_v.size();
+      double u = (xoffset - _hypo_grid_xmin) / _hypo_grid_step;
+      u = std::max(0., std::min(u, double(_hypo_grid_npts - 1)));
+      const size_t i = std::min((size_t)u, _hypo_grid_npts > 1 ? _hypo_grid_npts - 2 : 0);
+      const double f = (_hypo_grid_npts > 1 ? u - i : 0.);
+      const double* lo = &_hypo_grid_pe_v[i * nopdet];
+      const double* hi = (_hypo_grid_npts > 1 ? lo + nopdet : lo);
+      for (size_t ch = 0; ch < nopdet; ++ch)
+        _hypothesis.pe_v[ch] = (1. - f) * lo[ch] + f * hi[ch];
+
+      auto end = high_resolution_clock::now();
+      _construct_hypo_time += duration_cast<nanoseconds>(end - start).count();
+      return _hypothesis;
     }
+
+    // Apply xoffset
+    ApplyXOffset(xoffset);
     //auto end = high_resolution_clock::now();
     //auto duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration ChargeHypothesis 1 = " << duration.count() << "us" << std::endl;
@@ -364,6 +447,7 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
     //   if (n_original_photons > 1e20) std::cout << "n_original_photons " << n_original_photons << std::endl;
     // }
     FillEstimate(_var_trk, _hypothesis);
+    ++_construct_hypo_count;
     // std::cout << "hypo pe: ";
     // for (auto &v : _hypothesis.pe_v) std::cout << v << " ";
     //   std::cout << std::endl;;
@@ -386,6 +470,105 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
     return _hypothesis;
   }
 
+  void QLLMatch::ApplyXOffset(const double xoffset) {
+    _var_trk.resize(_raw_trk.size());
+    for (size_t pt_index = 0; pt_index < _raw_trk.size(); ++pt_index) {
+      //std::cout << "x point : " << _raw_trk[pt_index].x << "\t offset : " << xoffset << std::endl;
+      _var_trk[pt_index].x = _raw_trk[pt_index].x + xoffset;
+      _var_trk[pt_index].y = _raw_trk[pt_index].y;
+      _var_trk[pt_index].z = _raw_trk[pt_index].z;
+      _var_trk[pt_index].q = _raw_trk[pt_index].q;
+      if (_raw_trk[pt_index].q > 1e20) std::cout << "[QLLMatch::ChargeHypothesis] n_original_photons " << _raw_trk[pt_index].q << std::endl;
+    }
+  }
+
+  void QLLMatch::FillHypothesisGrid() {
+    auto start = high_resolution_clock::now();
+
+    const size_t nopdet = DetectorSpecs::GetME().NOpDets();
+    const size_t npts = (size_t)std::ceil((_vol_xmax - _vol_xmin) / _hypo_grid_step) + 1;
+
+    // The same cluster is matched to every flash: keep its grid, unless the
+    // combined TPC and flash mask changed with the flash
+    bool same = (npts == _hypo_grid_npts && _vol_xmin == _hypo_grid_xmin &&
+                 _tpc == _hypo_grid_tpc && _cryo == _hypo_grid_cryo &&
+                 _raw_trk.size() == _hypo_grid_trk.size() &&
+                 _raw_trk.tpc_mask_v == _hypo_grid_trk.tpc_mask_v);
+    for (size_t i = 0; same && i < _raw_trk.size(); ++i) {
+      auto const& a = _raw_trk[i];
+      auto const& b = _hypo_grid_trk[i];
+      same = (a.x == b.x && a.y == b.y && a.z == b.z && a.q == b.q);
+    }
+    if (same) return;
+
+    _hypo_grid_trk = _raw_trk;
+    _hypo_grid_xmin = _vol_xmin;
+    _hypo_grid_tpc = _tpc;
+    _hypo_grid_cryo = _cryo;
+    _hypo_grid_npts = npts;
+    _hypo_grid_pe_v.assign(npts * nopdet, 0.);
+
+    Flash_t hypothesis;
+    hypothesis.pe_v.resize(nopdet, 0.);
+    for (size_t i = 0; i < npts; ++i) {
+      for (auto &v : hypothesis.pe_v) v = 0;
+      ApplyXOffset(_hypo_grid_xmin + i * _hypo_grid_step);
+      FillEstimate(_var_trk, hypothesis);
+      ++_construct_hypo_count;
+      std::copy(hypothesis.pe_v.begin(), hypothesis.pe_v.end(), _hypo_grid_pe_v.begin() + i * nopdet);
+    }
+
+    auto end = high_resolution_clock::now();
+    _construct_hypo_time += duration_cast<nanoseconds>(end - start).count();
+    FLASH_DEBUG() << "Computed " << npts << " grid hypotheses" << std::endl;
+  }
+
+  double QLLMatch::ScanHypothesisGrid() {
+
+    // QLL at each node within the volume
+    std::vector<double> x_v, qll_v;
+    for (size_t i = 0; i < _hypo_grid_npts; ++i) {
+      const double x = std::min(_hypo_grid_xmin + i * _hypo_grid_step, _vol_xmax);
+      x_v.push_back(x);
+      qll_v.push_back(QLL(ChargeHypothesis(x), _measurement));
+      Record(x);
+      OneStep();
+      if (x >= _vol_xmax) break;
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < qll_v.size(); ++i) {
+      if (std::isnan(qll_v[best]) || qll_v[i] < qll_v[best]) best = i;
+    }
+
+    double reco_x = x_v[best];
+    double reco_x_err = _hypo_grid_step;
+
+    // Vertex of the parabola through the minimum and its neighbours. Its
+    // curvature gives the error as Minuit would with ERRDEF=1
+    if (best > 0 && best + 1 < qll_v.size()) {
+      const double x0 = x_v[best-1], x1 = x_v[best], x2 = x_v[best+1];
+      const double f0 = qll_v[best-1], f1 = qll_v[best], f2 = qll_v[best+1];
+      const double denom = (x0 - x1) * (x0 - x2) * (x1 - x2);
+      const double a = (x2 * (f1 - f0) + x1 * (f0 - f2) + x0 * (f2 - f1)) / denom;
+      const double b = (x2 * x2 * (f0 - f1) + x1 * x1 * (f2 - f0) + x0 * x0 * (f1 - f2)) / denom;
+      if (a > 0) {
+        reco_x = std::max(x0, std::min(x2, -b / (2. * a)));
+        reco_x_err = 1. / std::sqrt(a);
+      }
+    }
+
+    _converged = true;
+    _qll = QLL(ChargeHypothesis(reco_x), _measurement);
+    Record(reco_x);
+    OneStep();
+
+    _reco_x_offset = reco_x;
+    _reco_x_offset_err = reco_x_err;
+
+    return _qll;
+  }
+
   const Flash_t &QLLMatch::Measurement() const { return _measurement; }
 
   double QLLMatch::QLL(const Flash_t &hypothesis,
@@ -498,25 +681,25 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
     //std::cout << "minuit Xval?? : " << *Xval << std::endl;
 
     //auto start = high_resolution_clock::now();
-    auto const &hypothesis = QLLMatch::GetME()->ChargeHypothesis(*Xval);
+    auto const &hypothesis = __qll_fit_instance__->ChargeHypothesis(*Xval);
     //auto end = high_resolution_clock::now();
     //auto duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration ChargeHypothesis = " << duration.count() << "us" << std::endl;
 
     //start = high_resolution_clock::now();
-    auto const &measurement = QLLMatch::GetME()->Measurement();
+    auto const &measurement = __qll_fit_instance__->Measurement();
     //end = high_resolution_clock::now();
     //duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration Measurement = " << duration.count() << "us" << std::endl;
 
     //start = high_resolution_clock::now();
-    Fval = QLLMatch::GetME()->QLL(hypothesis, measurement);
+    Fval = __qll_fit_instance__->QLL(hypothesis, measurement);
     //end = high_resolution_clock::now();
     //duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration QLL = " << duration.count() << "us" << std::endl;
 
-    QLLMatch::GetME()->Record(Xval[0]);
-    QLLMatch::GetME()->OneStep();
+    __qll_fit_instance__->Record(Xval[0]);
+    __qll_fit_instance__->OneStep();
 
     return;
   }
@@ -565,6 +748,12 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
     _minimizer_record_x_v.clear();
     _num_steps = 0;
 
+    if (_hypo_grid_step > 0 && _hypo_grid_scan && _hypo_grid_npts)
+      return ScanHypothesisGrid();
+
+    std::lock_guard<std::mutex> minuit_lock(__qll_minuit_mutex__);
+    __qll_fit_instance__ = this;
+
     if (!_minuit_ptr) _minuit_ptr = new TMinuit(4);
      
     double reco_x = (_vol_xmax - _vol_xmin)/2;
@@ -587,8 +776,6 @@ FlashMatch_t QLLMatch::OnePMTMatch(const Flash_t& flash) {
     double arglist[4], Fmin, Fedm, Errdef;
     ierrflag = npari = nparx = istat = 0;
 
-    assert(this == QLLMatch::GetME());
-
     _minuit_ptr->SetPrintLevel(-1);
     arglist[0] = 2.0;  // set strategy level
     _minuit_ptr->mnexcm("SET STR", arglist, 1, ierrflag);
@@ -30,12 +30,15 @@
 #include "sbncode/OpT0Finder/flashmatch/Base/OpT0FinderException.h"
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <numeric>
 #include <cassert>
 #include <chrono>
 #include <climits>
+#include <limits>
+#include <mutex>
 #include <TMath.h>
 #include <TMinuit.h>
 
@@ -79,6 +82,14 @@ namespace flashmatch {
     /// Core function: execute matching
     FlashMatch_t Match(const QCluster_t&, const Flash_t&);
 
+    /// Copy for another thread. Minuit fits, which compute the hypotheses in
+    /// the Minuit callback, still run one at a time: with UseMinuit and
+    /// without HypothesisGridScan there is little left to run concurrently
+    BaseFlashMatch* Clone() const;
+
+    /// Score of this flash if the hypothesis matched it exactly on every channel
+    double ScoreBound(const QCluster_t&, const Flash_t&) const;
+
     const Flash_t& ChargeHypothesis(const double);
     const Flash_t& Measurement() const;
 
@@ -120,6 +131,15 @@ namespace flashmatch {
 
     FlashMatch_t OnePMTMatch(const Flash_t &flash);
 
+    /// Fill _var_trk with _raw_trk shifted by xoffset
+    void ApplyXOffset(const double xoffset);
+
+    /// Precompute the hypotheses of _raw_trk on the x offset grid, unless done already
+    void FillHypothesisGrid();
+
+    /// Minimize over the grid nodes, then refine with a parabola through the best three
+    double ScanHypothesisGrid();
+
     static QLLMatch* _me;
 
     QLLMode_t _mode;   ///< Minimizer mode
@@ -174,6 +194,15 @@ namespace flashmatch {
     std::vector<double> _xpos_v, _ypos_v, _zpos_v;
 
     float _construct_hypo_time; ///< Keeps track of the total time spent constructing hypotheses
+    size_t _construct_hypo_count; ///< Number of hypotheses computed with FillEstimate in this match
+
+    double _hypo_grid_step;   ///< X offset spacing of the precomputed hypotheses [cm], 0 to compute each one
+    bool   _hypo_grid_scan;   ///< Scan the grid and refine with a parabola instead of running Minuit
+    size_t _hypo_grid_npts;   ///< Number of grid hypotheses, 0 if none
+    double _hypo_grid_xmin;   ///< X offset of the first grid hypothesis
+    int    _hypo_grid_tpc, _hypo_grid_cryo;
+    flashmatch::QCluster_t _hypo_grid_trk; ///< Cluster the grid was computed for
+    std::vector<double> _hypo_grid_pe_v;   ///< Grid hypotheses, one NOpDets block per node
 
   };
 
@@ -0,0 +1,60 @@
+//
+// Throughput of the geometry calls made for every track segment:
+// GeoAlgo::Intersection(AABox, LineSegment) and LightPath::MakeQCluster.
+//
+//   geoalgo_bench [segments] [repetitions]
+//
+
+#include "flashmatch/GeoAlgo/GeoAlgo.h"
+#include "flashmatch/Algorithms/LightPath.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+int main(int argc, char** argv){
+
+  const size_t nsegments = (argc > 1) ? std::atol(argv[1]) : 100000;
+  const size_t nrepeat   = (argc > 2) ? std::atol(argv[2]) : 10;
+
+  // SBND-like active volume, with segments starting inside and outside of it
+  const ::geoalgo::AABox box(-200., -200., 0., 200., 200., 500.);
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> x(-250., 250.), y(-250., 250.), z(-50., 550.);
+  std::uniform_real_distribution<double> step(-30., 30.);
+
+  std::vector< ::geoalgo::LineSegment> segments;
+  segments.reserve(nsegments);
+  for(size_t i=0; i<nsegments; ++i) {
+    double sx = x(gen), sy = y(gen), sz = z(gen);
+    segments.emplace_back(sx, sy, sz, sx + step(gen), sy + step(gen), sz + step(gen));
+  }
+
+  const ::geoalgo::GeoAlgo algo;
+  size_t nxs = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(size_t r=0; r<nrepeat; ++r)
+    for(auto const& seg : segments) nxs += algo.Intersection(box, seg).size();
+  std::chrono::duration<double> xs_time = std::chrono::steady_clock::now() - start;
+
+  ::flashmatch::LightPath lightpath;
+  ::flashmatch::QCluster_t cluster;
+  size_t npts = 0;
+  start = std::chrono::steady_clock::now();
+  for(size_t r=0; r<nrepeat; ++r) {
+    for(auto const& seg : segments) {
+      cluster.clear();
+      lightpath.MakeQCluster(seg.Start(), seg.End(), cluster);
+      npts += cluster.size();
+    }
+  }
+  std::chrono::duration<double> qc_time = std::chrono::steady_clock::now() - start;
+
+  const double ncalls = double(nsegments) * nrepeat;
+  std::cout << "Intersection(AABox, LineSegment): " << ncalls / xs_time.count() * 1.e-6
+	    << " M segments/s (" << nxs << " crossings)" << std::endl
+	    << "LightPath::MakeQCluster:          " << ncalls / qc_time.count() * 1.e-6
+	    << " M segments/s (" << npts << " points)" << std::endl;
+
+  return 0;
+}
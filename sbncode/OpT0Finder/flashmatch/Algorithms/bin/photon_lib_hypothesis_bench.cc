@@ -0,0 +1,222 @@
+//
+// Time per estimate of the photon library kernel of
+// PhotonLibHypothesis::FillEstimateLibrary, as it was (PMTs outside,
+// points inside, one GetVisibility call per PMT and point) and as it is
+// (points outside, one voxel lookup and GetAllVisibilities row per point).
+// The art PhotonVisibilityService is replaced by a mock with the same calls:
+// a detector to library mapping (here a mirror in x, as for a library of
+// one cryostat half), the voxel lookup, and the table. Both kernels are
+// copies of the LArSoft build code. The estimates are compared exactly, and
+// the program exits with 1 if any PMT differs.
+//
+//   photon_lib_hypothesis_bench [points] [PMTs] [estimates]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace {
+
+  struct Point { double x, y, z; };
+
+  struct QPoint { double x, y, z, q; };
+
+  /// Stand-in for the MappedCounts_t row of GetAllVisibilities
+  class VisibilityRow {
+  public:
+    VisibilityRow(const float* data) : _data(data) {}
+    float operator[](size_t ch) const { return _data ? _data[ch] : 0.f; }
+  private:
+    const float* _data;
+  };
+
+  /// Stand-in for phot::PhotonVisibilityService
+  class MockVisibilityService {
+  public:
+    MockVisibilityService(size_t n_pmt, std::mt19937& gen)
+      : _n_pmt(n_pmt)
+      , _table((size_t)_nvox[0] * _nvox[1] * _nvox[2] * n_pmt)
+      , _refl_table(_table.size())
+    {
+      std::uniform_real_distribution<float> vis(0., 1.e-3);
+      for (auto& v : _table) v = (gen() % 4 == 0) ? vis(gen) : 0.f;
+      for (auto& v : _refl_table) v = (gen() % 4 == 0) ? vis(gen) : 0.f;
+    }
+
+    // Out of line, as the service calls are for the hypothesis
+    __attribute__((noinline)) int VoxelAt(Point const& p) const
+    {
+      const double lib[3] = {std::abs(p.x), p.y, p.z};
+      int id = 0;
+      for (size_t a = 0; a < 3; ++a) {
+        const double u = (lib[a] - _min[a]) / _size[a];
+        if (!(u >= 0.) || u >= _nvox[a]) return -1;
+        id = id * _nvox[a] + (int)u;
+      }
+      return id;
+    }
+
+    __attribute__((noinline)) float GetVisibility(Point const& p, size_t ch, bool refl = false) const
+    {
+      const int vox = VoxelAt(p);
+      if (vox < 0) return 0.f;
+      return (refl ? _refl_table : _table)[vox * _n_pmt + ch];
+    }
+
+    __attribute__((noinline)) VisibilityRow GetAllVisibilities(Point const& p, bool refl = false) const
+    {
+      const int vox = VoxelAt(p);
+      if (vox < 0) return VisibilityRow(nullptr);
+      return VisibilityRow(&(refl ? _refl_table : _table)[vox * _n_pmt]);
+    }
+
+  private:
+    size_t _n_pmt;
+    const double _min[3] = {0., -200., 0.};
+    const double _size[3] = {5., 5., 5.};
+    const int _nvox[3] = {80, 80, 100};
+    std::vector<float> _table, _refl_table;
+  };
+
+  // The rows are copied out under a lock, as in PhotonLibHypothesis
+  std::mutex vis_mutex;
+
+  struct Config {
+    size_t n_pmt;
+    double global_qe, global_qe_refl;
+    std::vector<double> qe_v, qe_refl_v;
+    std::vector<int> channel_mask, uncoated_pmt_list;
+  };
+
+  void FillEstimatePerPMT(MockVisibilityService const& vis, Config const& c,
+                          std::vector<QPoint> const& trk, std::vector<double>& pe_v)
+  {
+    for (auto& v : pe_v) v = 0;
+    for (size_t ipmt = 0; ipmt < c.n_pmt; ++ipmt) {
+      if (std::find(c.channel_mask.begin(), c.channel_mask.end(), ipmt) == c.channel_mask.end()) {
+        continue;
+      }
+      bool is_uncoated = false;
+      if (std::find(c.uncoated_pmt_list.begin(), c.uncoated_pmt_list.end(), ipmt) != c.uncoated_pmt_list.end()) {
+        is_uncoated = true;
+      }
+      for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
+        auto const& pt = trk[ipt];
+        double q = pt.q;
+        Point const xyz = {pt.x, pt.y, pt.z};
+        double q_direct = 0, q_refl = 0;
+        if (is_uncoated) {
+          q_direct = 0;
+        } else {
+          q_direct = q * vis.GetVisibility(xyz, ipmt) * c.global_qe * c.qe_v[ipmt];
+        }
+        q_refl = q * vis.GetVisibility(xyz, ipmt, true) * c.global_qe_refl * c.qe_refl_v[ipmt];
+        pe_v[ipmt] += q_direct;
+        pe_v[ipmt] += q_refl;
+      }
+    }
+  }
+
+  void FillEstimatePerPoint(MockVisibilityService const& vis, Config const& c,
+                            std::vector<QPoint> const& trk, std::vector<double>& pe_v)
+  {
+    for (auto& v : pe_v) v = 0;
+    const size_t n_pmt = c.n_pmt;
+    std::vector<double> qe_direct(n_pmt, 0.), qe_refl(n_pmt, 0.);
+    for (int ch : c.channel_mask) {
+      if (ch < 0 || (size_t)ch >= n_pmt) continue;
+      qe_direct[ch] = c.qe_v[ch];
+      qe_refl[ch] = c.qe_refl_v[ch];
+    }
+    for (int ch : c.uncoated_pmt_list) {
+      if (ch >= 0 && (size_t)ch < n_pmt) qe_direct[ch] = 0.;
+    }
+    const bool use_refl = c.global_qe_refl != 0.;
+    std::vector<float> vis_v(n_pmt);
+    for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
+      auto const& pt = trk[ipt];
+      Point const xyz = {pt.x, pt.y, pt.z};
+      if (vis.VoxelAt(xyz) < 0) continue;
+      double q = pt.q;
+      {
+        std::lock_guard<std::mutex> lock(vis_mutex);
+        auto const vis_direct = vis.GetAllVisibilities(xyz);
+        for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) vis_v[ipmt] = vis_direct[ipmt];
+      }
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+        pe_v[ipmt] += q * vis_v[ipmt] * c.global_qe * qe_direct[ipmt];
+      }
+      if (!use_refl) continue;
+      {
+        std::lock_guard<std::mutex> lock(vis_mutex);
+        auto const vis_refl = vis.GetAllVisibilities(xyz, true);
+        for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) vis_v[ipmt] = vis_refl[ipmt];
+      }
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+        pe_v[ipmt] += q * vis_v[ipmt] * c.global_qe_refl * qe_refl[ipmt];
+      }
+    }
+  }
+
+} // namespace
+
+int main(int argc, char** argv){
+
+  const size_t npts      = (argc > 1) ? std::atol(argv[1]) : 2000;
+  const size_t n_pmt     = (argc > 2) ? std::atol(argv[2]) : 360;
+  const size_t nestimate = (argc > 3) ? std::atol(argv[3]) : 20;
+
+  std::mt19937 gen(12345);
+  MockVisibilityService vis(n_pmt, gen);
+
+  // Every other PMT uncoated, a few masked out
+  Config c;
+  c.n_pmt = n_pmt;
+  c.global_qe = 0.0093;
+  c.qe_v.assign(n_pmt, 1.);
+  c.qe_refl_v.assign(n_pmt, 0.8);
+  for (size_t ch = 0; ch < n_pmt; ++ch) {
+    if (ch % 17 != 0) c.channel_mask.push_back(ch);
+    if (ch % 2 == 1) c.uncoated_pmt_list.push_back(ch);
+  }
+
+  // A track crossing the cathode, partly outside of the library in y
+  std::vector<QPoint> trk;
+  for (size_t i = 0; i < npts; ++i) {
+    const double f = double(i) / npts;
+    trk.push_back({-150. + 300. * f, -250. + 400. * f, 20. + 400. * f, 100. + (gen() % 1000)});
+  }
+
+  std::vector<double> old_pe(n_pmt), new_pe(n_pmt);
+  std::cout << "GlobalQERefl   per PMT [ms/estimate]   per point [ms/estimate]   PMTs differing" << std::endl;
+  size_t ndiff_total = 0;
+  for (double global_qe_refl : {0., 0.03}) {
+    c.global_qe_refl = global_qe_refl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nestimate; ++i) FillEstimatePerPMT(vis, c, trk, old_pe);
+    std::chrono::duration<double, std::milli> old_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nestimate; ++i) FillEstimatePerPoint(vis, c, trk, new_pe);
+    std::chrono::duration<double, std::milli> new_time = std::chrono::steady_clock::now() - start;
+
+    size_t ndiff = 0;
+    for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+      if (old_pe[ipmt] != new_pe[ipmt]) ++ndiff;
+    }
+    ndiff_total += ndiff;
+
+    std::cout << global_qe_refl << "\t\t" << old_time.count() / nestimate
+	      << "\t\t\t" << new_time.count() / nestimate
+	      << "\t\t\t" << ndiff << std::endl;
+  }
+
+  return ndiff_total ? 1 : 0;
+}
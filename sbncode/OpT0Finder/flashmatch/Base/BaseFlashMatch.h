@@ -16,6 +16,7 @@
 
 #include "BaseAlgorithm.h"
 #include "BaseFlashHypothesis.h"
+#include <limits>
 namespace flashmatch {
 
   class FlashMatchManager;
@@ -54,6 +55,22 @@ namespace flashmatch {
      */
     virtual FlashMatch_t Match(const QCluster_t&, const Flash_t&) = 0;
 
+    /**
+       Creates an independent copy of this algorithm, with the same configuration and flash \n
+       hypothesis algorithm, that the caller owns. flashmatch::FlashMatchManager gives one to \n
+       each thread to match pairs concurrently. Algorithms that cannot run in several threads \n
+       return nullptr (the default), and are then run serially.
+     */
+    virtual BaseFlashMatch* Clone() const { return nullptr; }
+
+    /**
+       Upper bound on the score Match() can return for this pair, cheap to compute. \n
+       flashmatch::FlashMatchManager skips the pairs that cannot beat a match already found. \n
+       The default, the largest double, never skips anything.
+     */
+    virtual double ScoreBound(const QCluster_t&, const Flash_t&) const
+    { return std::numeric_limits<double>::max(); }
+
     /// Method to call flash hypothesis
     Flash_t GetEstimate(const QCluster_t&) const;
 
@@ -62,7 +62,7 @@ namespace flashmatch{
   float DetectorSpecs::GetVisibility(double x, double y, double z, unsigned int opch) const
   { return phot::PhotonVisibilityService::GetME().GetVisibility(x,y,z,opch); }
 
-  const std::vector<std::vector<float > >& DetectorSpecs::GetPhotonLibraryData() const
+  phot::PhotonLibraryData DetectorSpecs::GetPhotonLibraryData() const
   { return phot::PhotonVisibilityService::GetME().GetLibraryData(); }
 }
 
@@ -12,6 +12,7 @@
 #include "FMWKTools/ConfigManager.h"
 #include "flashmatch/GeoAlgo/GeoAABox.h"
 #include "FMWKTools/PhotonVoxels.h"
+#include "FMWKTools/PhotonLibrary.h"
 namespace flashmatch {
   /// Configuration object
   using Config_t = flashmatch::PSet;
@@ -68,11 +69,11 @@ namespace flashmatch {
     /// Visibility Reflected
     float GetVisibilityReflected(double x, double y, double z, unsigned int opch) const;
 
+    #if USING_LARSOFT == 0
     /// Photon Library data access FIXME
-    const std::vector<std::vector<float > >& GetPhotonLibraryData() const;
+    phot::PhotonLibraryData GetPhotonLibraryData() const;
 
     /// Voxel definition
-    #if USING_LARSOFT == 0
     inline const sim::PhotonVoxelDef& GetVoxelDef() const { return _voxel_def; }
     #endif
 
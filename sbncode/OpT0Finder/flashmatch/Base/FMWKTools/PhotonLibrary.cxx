@@ -8,29 +8,65 @@
 #include "PhotonLibrary.h"
 #include "PhotonVoxels.h"
 #include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 //#include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "TFile.h"
 #include "TTree.h"
 #include "TKey.h"
 
-namespace phot{
+namespace {
+
+  // Flat library layout: this header, padded to kFlatHeaderSize bytes, then
+  // NVoxels*NOpChannels native-endian floats, voxel-major
+  const char   kFlatMagic[8]   = {'F','M','P','H','L','I','B','1'};
+  const size_t kFlatHeaderSize = 64;
+
+  struct FlatLibraryHeader {
+    char     magic[8];
+    uint64_t n_voxels;
+    uint64_t n_opchannels;
+  };
+  static_assert(sizeof(FlatLibraryHeader) <= kFlatHeaderSize, "flat library header too large");
 
-  std::vector<float> PhotonLibrary::EmptyChannelsList; // used for invalid return value
+}
+
+namespace phot{
 
   //------------------------------------------------------------
 
   PhotonLibrary::PhotonLibrary()
-  {
-    fLookupTable.clear();
-  }
+    : fData(nullptr)
+    , fMapped(nullptr)
+    , fMappedSize(0)
+    , fNOpChannels(0)
+    , fNVoxels(0)
+  {}
 
 
   //------------------------------------------------------------
 
   PhotonLibrary::~PhotonLibrary()
   {
-    fLookupTable.clear();
+    Unmap();
+  }
+
+  //------------------------------------------------------------
+
+  void PhotonLibrary::Unmap()
+  {
+    if(fMapped) munmap(fMapped, fMappedSize);
+    fMapped = nullptr;
+    fMappedSize = 0;
+    fData = fLookupTable.data();
   }
 
   //------------------------------------------------------------
@@ -53,15 +89,16 @@ namespace phot{
     tt->Branch("Visibility", &Visibility, "Visibility/F");
 
 
-    for(size_t ivox=0; ivox!=fLookupTable.size(); ++ivox)
+    for(size_t ivox=0; ivox!=fNVoxels; ++ivox)
       {
-	for(size_t ichan=0; ichan!=fLookupTable.at(ivox).size(); ++ichan)
+	const float* counts = GetCounts(ivox);
+	for(size_t ichan=0; ichan!=fNOpChannels; ++ichan)
 	  {
-	    if(fLookupTable[ivox].at(ichan) > 0)
+	    if(counts[ichan] > 0)
 	      {
 		Voxel      = ivox;
 		OpChannel  = ichan;
-		Visibility = fLookupTable[ivox][ichan];
+		Visibility = counts[ichan];
 		tt->Fill();
 	      }
 	  }
@@ -76,17 +113,13 @@ namespace phot{
 
   void PhotonLibrary::CreateEmptyLibrary( size_t NVoxels, size_t NOpChannels)
   {
-    fLookupTable.clear();
+    Unmap();
 
     fNVoxels     = NVoxels;
     fNOpChannels = NOpChannels;
 
-    fLookupTable.resize(NVoxels);
-
-    for(size_t ivox=0; ivox!=NVoxels; ivox++)
-      {
-        fLookupTable[ivox].resize(NOpChannels,0);
-      }
+    fLookupTable.assign(NVoxels*NOpChannels, 0);
+    fData = fLookupTable.data();
   }
 
 
@@ -94,6 +127,7 @@ namespace phot{
 
   void PhotonLibrary::LoadLibraryFromFile(std::string LibraryFile, size_t NVoxels)
   {
+    Unmap();
     fLookupTable.clear();
 
     std::cout<< "Reading photon library from input file: " << LibraryFile.c_str()<<std::endl;
@@ -137,35 +171,49 @@ namespace phot{
 
 
     fNVoxels     = NVoxels;
-    fNOpChannels = 1;      // Minimum default, overwritten by library reading
-
-
-    fLookupTable.resize(NVoxels);
+    // # of optical channels is 1 more than the largest one in the library,
+    // which is only known at the end of the single pass over the tree
+    fNOpChannels = 1;      // Minimum default
 
+    // Only the voxels seen so far are allocated, with a row of fNOpChannels.
+    // Libraries are written voxel by voxel, so the channel count is mostly
+    // settled while few rows exist, which makes widening them cheap; the
+    // later rows are added in place, in the reserved final size.
+    size_t NRows = 0;
+    fLookupTable.reserve(fNVoxels*fNOpChannels);
 
     size_t NEntries = tt->GetEntries();
 
     for(size_t i=0; i!=NEntries; ++i) {
       tt->GetEntry(i);
 
-      // Set # of optical channels to 1 more than largest one seen
-      if (OpChannel >= (int)fNOpChannels)
-        fNOpChannels = OpChannel+1;
+      if (Voxel < 0 || Voxel >= (int)fNVoxels || OpChannel < 0) continue;
+
+      // Widen the rows seen so far to the new channel count
+      if (OpChannel >= (int)fNOpChannels) {
+	const size_t NewNOpChannels = OpChannel + 1;
+	std::vector<float> table;
+	table.reserve(fNVoxels*NewNOpChannels);
+	table.resize(NRows*NewNOpChannels, 0);
+	for(size_t ivox=0; ivox!=NRows; ++ivox)
+	  std::copy_n(fLookupTable.data() + ivox*fNOpChannels, fNOpChannels,
+		      table.data() + ivox*NewNOpChannels);
+	fLookupTable.swap(table);
+	fNOpChannels = NewNOpChannels;
+      }
 
-      // Expand this voxel's vector if needed
-      if (fLookupTable[Voxel].size() < fNOpChannels)
-        fLookupTable[Voxel].resize(fNOpChannels, 0);
+      if ((size_t)Voxel >= NRows) {
+	NRows = Voxel + 1;
+	fLookupTable.resize(NRows*fNOpChannels, 0);
+      }
 
       // Set the visibility at this optical channel
-      fLookupTable[Voxel][OpChannel] = Visibility;
+      fLookupTable[Voxel*fNOpChannels + OpChannel] = Visibility;
     }
 
-    // Go through the table and fill in any missing 0's
-    for(size_t ivox=0; ivox!=NVoxels; ivox++)
-    {
-      if (fLookupTable[ivox].size() < fNOpChannels)
-	fLookupTable[ivox].resize(fNOpChannels,0);
-    }
+    // Missing voxels stay 0
+    fLookupTable.resize(fNVoxels*fNOpChannels, 0);
+    fData = fLookupTable.data();
 
 
     std::cout <<  NVoxels << " voxels,  " << fNOpChannels<<" channels" <<std::endl;
@@ -181,6 +229,91 @@ namespace phot{
       }
   }
 
+  //------------------------------------------------------------
+
+  void PhotonLibrary::StoreFlatLibraryToFile(std::string LibraryFile) const
+  {
+    std::cout << "Writing flat photon library to file: " << LibraryFile.c_str()<<std::endl;
+
+    std::ofstream fout(LibraryFile, std::ios::binary | std::ios::trunc);
+    if(!fout) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed to open: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    char header[kFlatHeaderSize] = {0};
+    FlatLibraryHeader h;
+    std::memcpy(h.magic, kFlatMagic, sizeof(h.magic));
+    h.n_voxels     = fNVoxels;
+    h.n_opchannels = fNOpChannels;
+    std::memcpy(header, &h, sizeof(h));
+
+    fout.write(header, kFlatHeaderSize);
+    fout.write(reinterpret_cast<const char*>(fData), fNVoxels*fNOpChannels*sizeof(float));
+    if(!fout) {
+      std::cerr << "Error writing flat photon library: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+  }
+
+  //------------------------------------------------------------
+
+  bool PhotonLibrary::IsFlatLibraryFile(std::string LibraryFile)
+  {
+    std::ifstream fin(LibraryFile, std::ios::binary);
+    char magic[sizeof(kFlatMagic)] = {0};
+    if(!fin.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, kFlatMagic, sizeof(magic)) == 0;
+  }
+
+  //------------------------------------------------------------
+
+  void PhotonLibrary::LoadFlatLibraryFromFile(std::string LibraryFile, size_t NVoxels)
+  {
+    Unmap();
+    fLookupTable.clear();
+
+    std::cout<< "Mapping flat photon library from input file: " << LibraryFile.c_str()<<std::endl;
+
+    int fd = open(LibraryFile.c_str(), O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < kFlatHeaderSize) {
+      if(fd >= 0) close(fd);
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed to open a flat photon library: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping stays valid
+    if(mapped == MAP_FAILED) {
+      std::cerr << "Failed to mmap photon library: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+    fMapped     = mapped;
+    fMappedSize = st.st_size;
+
+    FlatLibraryHeader h;
+    std::memcpy(&h, mapped, sizeof(h));
+    if(std::memcmp(h.magic, kFlatMagic, sizeof(h.magic)) != 0 ||
+       fMappedSize != kFlatHeaderSize + h.n_voxels*h.n_opchannels*sizeof(float)) {
+      Unmap();
+      std::cerr << "Not a valid flat photon library: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+    if(h.n_voxels != NVoxels) {
+      Unmap();
+      std::cerr << "Flat photon library " << LibraryFile.c_str() << " has " << h.n_voxels
+		<< " voxels, the voxel definition " << NVoxels << std::endl;
+      throw std::exception();
+    }
+
+    fNVoxels     = h.n_voxels;
+    fNOpChannels = h.n_opchannels;
+    fData = reinterpret_cast<const float*>(static_cast<const char*>(mapped) + kFlatHeaderSize);
+
+    std::cout <<  fNVoxels << " voxels,  " << fNOpChannels<<" channels" <<std::endl;
+  }
+
   //----------------------------------------------------
 
   float PhotonLibrary::GetCount(size_t Voxel, size_t OpChannel)
@@ -188,7 +321,7 @@ namespace phot{
     //if(/*(Voxel<0)||*/(Voxel>=fNVoxels)||/*(OpChannel<0)||*/(OpChannel>=fNOpChannels))
     //  return 0;
     //else
-      return fLookupTable[Voxel][OpChannel]; 
+      return fData[Voxel*fNOpChannels + OpChannel]; 
   }
 
   //----------------------------------------------------
@@ -197,18 +330,20 @@ namespace phot{
   {
     if(/*(Voxel<0)||*/(Voxel>=fNVoxels))
       std::cerr <<"Error - attempting to set count in voxel " << Voxel<<" which is out of range" <<std::endl;
+    else if(fMapped)
+      std::cerr <<"Error - attempting to set count in a memory-mapped library" <<std::endl;
     else
-      fLookupTable[Voxel].at(OpChannel) = Count;
+      fLookupTable.at(Voxel*fNOpChannels + OpChannel) = Count;
   }
 
   //----------------------------------------------------
 
-  const std::vector<float>* PhotonLibrary::GetCounts(size_t Voxel) const
+  const float* PhotonLibrary::GetCounts(size_t Voxel) const
   {
     if(/*(Voxel<0)||*/(Voxel>=fNVoxels))
-      return EmptyList(); // FIXME!!! better to throw an exception!
+      return nullptr; // FIXME!!! better to throw an exception!
     else
-      return &(fLookupTable[Voxel]);
+      return fData + Voxel*fNOpChannels;
   }
 
 
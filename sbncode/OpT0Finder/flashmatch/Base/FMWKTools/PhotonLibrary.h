@@ -12,38 +12,71 @@
 #include <string>
 
 namespace phot{
-  
+
+  /// Read-only view of a voxel-major visibility table: lib[voxel][opchannel]
+  class PhotonLibraryData
+  {
+  public:
+    PhotonLibraryData(const float* data=nullptr, size_t NVoxels=0, size_t NOpChannels=0)
+      : fData(data), fNVoxels(NVoxels), fNOpChannels(NOpChannels) {}
+
+    /// Visibilities of all the channels for this voxel
+    inline const float* operator[](size_t Voxel) const { return fData + Voxel*fNOpChannels; }
+
+    inline const float* data() const { return fData; }
+    inline size_t size() const { return fNVoxels; }
+    inline size_t NOpChannels() const { return fNOpChannels; }
+
+  private:
+    const float* fData;
+    size_t fNVoxels;
+    size_t fNOpChannels;
+  };
+
   class PhotonLibrary
   {
   public:
     PhotonLibrary();
     ~PhotonLibrary();
 
+    PhotonLibrary(const PhotonLibrary&) = delete;
+    PhotonLibrary& operator=(const PhotonLibrary&) = delete;
+
     float GetCount(size_t Voxel, size_t OpChannel);
     void   SetCount(size_t Voxel, size_t OpChannel, float Count);
-    
-    const std::vector<float>* GetCounts(size_t Voxel) const;
-    inline const std::vector<std::vector<float> >& GetData() const
-    { return fLookupTable; }
-    
+
+    /// NOpChannels() visibilities for this voxel, nullptr if out of range
+    const float* GetCounts(size_t Voxel) const;
+    inline PhotonLibraryData GetData() const
+    { return PhotonLibraryData(fData, fNVoxels, fNOpChannels); }
+
     void StoreLibraryToFile(std::string LibraryFile);
     void LoadLibraryFromFile(std::string LibraryFile, size_t NVoxels);
     void CreateEmptyLibrary(size_t NVoxels, size_t NChannels);
-    
+
+    /// Write the table as a flat binary file (see LoadFlatLibraryFromFile)
+    void StoreFlatLibraryToFile(std::string LibraryFile) const;
+    /// Map a flat binary library into memory. The pages are shared by all
+    /// the processes on the node reading the same file, and only read from
+    /// disk when touched. The library is read-only afterwards.
+    void LoadFlatLibraryFromFile(std::string LibraryFile, size_t NVoxels);
+    /// Whether this file is a flat binary library, rather than a ROOT one
+    static bool IsFlatLibraryFile(std::string LibraryFile);
 
     int NOpChannels() const { return fNOpChannels; }
     int NVoxels() const { return fNVoxels; }
-    
+
   private:
-    // fLookupTable[Voxel]->at(OpChannel) = Count
-    std::vector<std::vector<float> > fLookupTable;
+    void Unmap();
+
+    // Voxel-major: fData[Voxel*fNOpChannels + OpChannel] = Count. Points
+    // either to fLookupTable or to the mapped file
+    const float* fData;                //!
+    std::vector<float> fLookupTable;
+    void*  fMapped;                    //! mmap-ed flat library, if any
+    size_t fMappedSize;                //!
     size_t fNOpChannels;
     size_t fNVoxels;
-    
-    static std::vector<float> EmptyChannelsList;
-    
-    static std::vector<float>* EmptyList()
-      { EmptyChannelsList.clear(); return &EmptyChannelsList; }
   };
 
 }
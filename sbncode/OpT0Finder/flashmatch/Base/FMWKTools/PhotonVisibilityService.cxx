@@ -103,8 +103,9 @@ namespace phot{
       for(int iz=0; iz<fNz; ++iz) {
 	int vox_id = iy*fNx + iz * (fNy + fNx);
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
-	  vis_sum += ((double)(vis_pmt));
+	const float* vis_pmt = fTheLibrary->GetCounts(vox_id);
+	for(int ich=0; vis_pmt && ich<fTheLibrary->NOpChannels(); ++ich)
+	  vis_sum += ((double)(vis_pmt[ich]));
 	result[iy][iz] = vis_sum;
       }
     }
@@ -123,8 +124,9 @@ namespace phot{
       for(int iz=0; iz<fNz; ++iz) {
 	int vox_id = ix + iz * (fNy + fNx);
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
-	  vis_sum += ((double)(vis_pmt));
+	const float* vis_pmt = fTheLibrary->GetCounts(vox_id);
+	for(int ich=0; vis_pmt && ich<fTheLibrary->NOpChannels(); ++ich)
+	  vis_sum += ((double)(vis_pmt[ich]));
 	result[iz][ix] = vis_sum;
       }
     }
@@ -143,8 +145,9 @@ namespace phot{
       for(int iy=0; iy<fNy; ++iy) {
 	int vox_id = ix + iy * fNx;
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
-	  vis_sum += ((double)(vis_pmt));
+	const float* vis_pmt = fTheLibrary->GetCounts(vox_id);
+	for(int ich=0; vis_pmt && ich<fTheLibrary->NOpChannels(); ++ich)
+	  vis_sum += ((double)(vis_pmt[ich]));
 	result[ix][iy] = vis_sum;
       }
     }
@@ -185,7 +188,12 @@ namespace phot{
 		    << LibraryFileWithPath
 		    << std::endl;
 	  size_t NVoxels = GetVoxelDef().GetNVoxels();
-	  fTheLibrary->LoadLibraryFromFile(LibraryFileWithPath, NVoxels);
+	  // Flat libraries (see PhotonLibrary::StoreFlatLibraryToFile) are mapped
+	  // rather than read
+	  if(PhotonLibrary::IsFlatLibraryFile(LibraryFileWithPath))
+	    fTheLibrary->LoadFlatLibraryFromFile(LibraryFileWithPath, NVoxels);
+	  else
+	    fTheLibrary->LoadLibraryFromFile(LibraryFileWithPath, NVoxels);
 	}
       }
       else {
@@ -232,7 +240,7 @@ namespace phot{
   // Get a vector of the relative visibilities of each OpDet
   //  in the event to a point xyz
 
-  const std::vector<float>* PhotonVisibilityService::GetAllVisibilities(double * xyz) const
+  const float* PhotonVisibilityService::GetAllVisibilities(double * xyz) const
   {
     int VoxID = fVoxelDef.GetVoxelID(xyz);
     return GetLibraryEntries(VoxID);
@@ -311,7 +319,7 @@ namespace phot{
 
 
 
-  const std::vector<float>* PhotonVisibilityService::GetLibraryEntries(int VoxID) const
+  const float* PhotonVisibilityService::GetLibraryEntries(int VoxID) const
   {
     if(fTheLibrary == 0)
       LoadLibrary();
@@ -56,9 +56,9 @@ namespace phot{
     inline int    GetNZ() const { return fNz; }
     inline size_t GetNOpChannels() const { return fNOpDetChannels; }
 
-    const std::vector<float>* GetAllVisibilities( double* xyz ) const;
+    const float* GetAllVisibilities( double* xyz ) const;
 
-    inline const std::vector<std::vector<float> >& GetLibraryData() const
+    inline PhotonLibraryData GetLibraryData() const
     { if(!fTheLibrary) LoadLibrary(); return fTheLibrary->GetData(); }
     
     void LoadLibrary() const;
@@ -70,7 +70,7 @@ namespace phot{
     
     void SetLibraryEntry(   int VoxID, int OpChannel, float N);
     float GetLibraryEntry( int VoxID, int OpChannel) const;
-    const std::vector<float>* GetLibraryEntries( int VoxID ) const;
+    const float* GetLibraryEntries( int VoxID ) const;
 
     
     bool IsBuildJob() const { return fLibraryBuildJob; }
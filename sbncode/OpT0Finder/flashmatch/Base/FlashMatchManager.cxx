@@ -12,7 +12,17 @@
 #include "FlashHypothesisFactory.h"
 #include "FlashProhibitFactory.h"
 #include "CustomAlgoFactory.h"
+#include <algorithm>
 #include <chrono>
+#include <limits>
+#include <memory>
+
+#if USING_LARSOFT == 1
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+#endif
 
 using namespace std::chrono;
 namespace flashmatch {
@@ -50,6 +60,9 @@ namespace flashmatch {
     _allow_reuse_flash = mgr_cfg.get<bool>("AllowReuseFlash");
     this->set_verbosity((msg::Level_t)(mgr_cfg.get<unsigned int>("Verbosity")));
     _store_full = mgr_cfg.get<bool>("StoreFullResult");
+    _num_threads = mgr_cfg.get<unsigned int>("NumThreads", 1);
+    _prune_fits = mgr_cfg.get<bool>("PruneFits", false);
+    _prune_validate = mgr_cfg.get<bool>("PruneValidate", false);
 
     auto const flash_filter_name = mgr_cfg.get<std::string>("FlashFilterAlgo","");
     auto const tpc_filter_name   = mgr_cfg.get<std::string>("TPCFilterAlgo","");
@@ -207,12 +220,11 @@ namespace flashmatch {
     // use multi-map for possible equally-scored matches
     std::multimap<double, FlashMatch_t> score_map;
 
-    // Double loop over a list of tpc object & flash
-    // Call matching function to inspect the compatibility.
+    // Double loop over a list of tpc object & flash, to list the pairs to inspect
+    std::vector<std::pair<size_t, ID_t> > pair_v;
     for (size_t tpc_index = 0; tpc_index < tpc_index_v.size(); ++tpc_index) {
       // Loop over flash list
       for (auto const& flash_index : flash_index_v) {
-        FLASH_INFO() << "TPC index " << tpc_index << ", Flash index " << flash_index << std::endl;
         auto const& tpc   = _tpc_object_v[tpc_index_v[tpc_index]]; // Retrieve TPC object
         auto const& flash = _flash_v[flash_index];    // Retrieve flash
 
@@ -223,57 +235,230 @@ namespace flashmatch {
         if (_alg_match_prohibit) {
           bool compat = _alg_match_prohibit->MatchCompatible( tpc, flash);
           if (compat == false) {
-            FLASH_INFO() << "Match not compatible. " << std::endl;
+            FLASH_INFO() << "TPC index " << tpc_index << ", Flash index " << flash_index
+                         << ": Match not compatible. " << std::endl;
             continue;
           }
         }
-        auto start = high_resolution_clock::now();
-        auto res = _alg_flash_match->Match( tpc, flash ); // Run matching
-        auto end = high_resolution_clock::now();
-        auto duration = duration_cast<nanoseconds>(end - start);
-        FLASH_INFO() << "Match duration = " << duration.count() << "ns" << std::endl;
+        pair_v.emplace_back(tpc_index, flash_index);
+      }
+    }
 
-        // ignore this match if the score is <= 0
-        if (res.score <= 0) continue;
+    // Pruning is exact only if each TPC object simply keeps its best flash, and
+    // only if the pruned pairs are not needed in the full result
+    bool prune = _prune_fits;
+    if (prune && (!_allow_reuse_flash || _store_full)) {
+      FLASH_WARNING() << "PruneFits needs AllowReuseFlash and no StoreFullResult: not pruning" << std::endl;
+      prune = false;
+    }
 
-        // Else we store this match. Assign TPC & flash index info
-        res.tpc_id = tpc_index_v[tpc_index];//_index;
-        res.flash_id = flash_index;//_index;
-        res.duration = duration.count();
+    // Upper bound on the score of each pair
+    std::vector<double> bound_v(pair_v.size(), std::numeric_limits<double>::max());
+    if (prune) {
+      for (size_t pair_index = 0; pair_index < pair_v.size(); ++pair_index)
+        bound_v[pair_index] = _alg_flash_match->ScoreBound(_tpc_object_v[tpc_index_v[pair_v[pair_index].first]],
+                                                           _flash_v[pair_v[pair_index].second]);
+    }
+
+    // Units of work, each handled by one thread: all the pairs of one TPC
+    // object when pruning, one pair otherwise
+    std::vector<std::pair<size_t, size_t> > group_v;
+    for (size_t pair_index = 0; pair_index < pair_v.size(); ++pair_index) {
+      if (prune && !group_v.empty() && pair_v[group_v.back().first].first == pair_v[pair_index].first)
+        group_v.back().second = pair_index + 1;
+      else
+        group_v.emplace_back(pair_index, pair_index + 1);
+    }
+
+    // Call matching function to inspect the compatibility.
+    std::vector<FlashMatch_t> pair_res_v(pair_v.size());
+    std::vector<char> pruned_v(pair_v.size(), 0);
+    auto match_pair = [&](BaseFlashMatch* alg, size_t pair_index) {
+      auto const& tpc_index   = pair_v[pair_index].first;
+      auto const& flash_index = pair_v[pair_index].second;
+      FLASH_INFO() << "TPC index " << tpc_index << ", Flash index " << flash_index << std::endl;
+
+      auto start = high_resolution_clock::now();
+      auto res = alg->Match( _tpc_object_v[tpc_index_v[tpc_index]], _flash_v[flash_index] ); // Run matching
+      auto end = high_resolution_clock::now();
+      auto duration = duration_cast<nanoseconds>(end - start);
+      FLASH_INFO() << "Match duration = " << duration.count() << "ns" << std::endl;
+
+      // Assign TPC & flash index info
+      res.tpc_id = tpc_index_v[tpc_index];//_index;
+      res.flash_id = flash_index;//_index;
+      res.duration = duration.count();
+      pair_res_v[pair_index] = std::move(res);
+    };
+    auto match_group = [&](BaseFlashMatch* alg, size_t group_index) {
+      auto const& range = group_v[group_index];
+      if (!prune) {
+        for (size_t pair_index = range.first; pair_index < range.second; ++pair_index)
+          match_pair(alg, pair_index);
+        return;
+      }
 
+      // Fit the most promising flashes first. A pair is skipped once its bound
+      // cannot beat the best match found for this TPC object: it would come
+      // after it in score_map, whose key is 1/score and where ties keep the
+      // pair order, so the assignment would never pick it
+      std::vector<size_t> order_v;
+      for (size_t pair_index = range.first; pair_index < range.second; ++pair_index)
+        order_v.push_back(pair_index);
+      std::stable_sort(order_v.begin(), order_v.end(),
+                       [&](size_t a, size_t b) { return bound_v[a] > bound_v[b]; });
+
+      double best_key = 0.;
+      size_t best_index = pair_v.size();
+      auto hopeless = [&](size_t pair_index) {
+        // A score <= 0 is ignored anyway
+        if (bound_v[pair_index] <= 0) return true;
+        if (best_index == pair_v.size()) return false;
+        const double key = 1. / bound_v[pair_index];
+        return key > best_key || (key == best_key && pair_index > best_index);
+      };
+
+      for (auto const& pair_index : order_v) {
+        if (hopeless(pair_index)) {
+          pruned_v[pair_index] = 1;
+          if (!_prune_validate) continue;
+        }
+        match_pair(alg, pair_index);
+        if (pruned_v[pair_index]) continue;
+
+        auto const& score = pair_res_v[pair_index].score;
+        if (score <= 0) continue;
+        const double key = 1. / score;
+        if (best_index == pair_v.size() || key < best_key || (key == best_key && pair_index < best_index)) {
+          best_key = key;
+          best_index = pair_index;
+        }
+      }
+    };
+
+    bool parallel = false;
+    #if USING_LARSOFT == 1
+    if (_num_threads > 1 && group_v.size() > 1) {
+      std::unique_ptr<BaseFlashMatch> probe(_alg_flash_match->Clone());
+      if (probe) {
+        parallel = true;
+        // One copy of the matching algorithm per thread, made from its current
+        // configuration. Pairs are ordered TPC object first, so each thread
+        // mostly sees consecutive flashes of the same TPC object
+        tbb::enumerable_thread_specific<std::unique_ptr<BaseFlashMatch> > alg_copies
+          ([this] { return std::unique_ptr<BaseFlashMatch>(_alg_flash_match->Clone()); });
+        tbb::task_arena arena(_num_threads);
+        arena.execute([&] {
+          tbb::parallel_for(tbb::blocked_range<size_t>(0, group_v.size()),
+            [&](const tbb::blocked_range<size_t> &range) {
+              BaseFlashMatch* alg = alg_copies.local().get();
+              for (size_t group_index = range.begin(); group_index != range.end(); ++group_index)
+                match_group(alg, group_index);
+            });
+        });
+      }
+      else
+        FLASH_WARNING() << _alg_flash_match->AlgorithmName()
+                        << " cannot be copied: matching serially" << std::endl;
+    }
+    #endif
+    if (!parallel) {
+      for (size_t group_index = 0; group_index < group_v.size(); ++group_index)
+        match_group(_alg_flash_match, group_index);
+    }
 
-        if(_store_full) {
-          _res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
-          _res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
+    _num_fits = _num_pruned_fits = 0;
+    for (auto const& pruned : pruned_v) {
+      if (pruned) ++_num_pruned_fits;
+      else ++_num_fits;
+    }
+    _num_fits_total += _num_fits;
+    _num_pruned_fits_total += _num_pruned_fits;
+    if (prune)
+      FLASH_INFO() << "Pruned " << _num_pruned_fits << " of " << pair_v.size() << " fits" << std::endl;
+
+    // Collect the results in the pair order, so that equally-scored matches
+    // are ordered as in a serial run whatever the number of threads. With
+    // PruneValidate, the pruned pairs were fit too and are kept aside
+    std::multimap<double, FlashMatch_t> unpruned_score_map;
+    for (size_t pair_index = 0; pair_index < pair_v.size(); ++pair_index) {
+      auto& res = pair_res_v[pair_index];
+
+      // ignore this match if the score is <= 0
+      if (res.score <= 0) continue;
+
+      auto const& tpc_index = pair_v[pair_index].first;
+      auto const& flash_index = pair_v[pair_index].second;
+      auto const& tpc   = _tpc_object_v[res.tpc_id];
+      auto const& flash = _flash_v[res.flash_id];
+
+      if (_prune_validate && prune) {
+        if (res.score > bound_v[pair_index]) {
+          FLASH_WARNING() << "TPC index " << tpc_index << ", Flash index " << flash_index
+                          << ": score " << res.score << " above its bound " << bound_v[pair_index] << std::endl;
         }
-        // For ordering purpose, take an inverse of the score for sorting
-        score_map.emplace( 1. / res.score, res);
+        unpruned_score_map.emplace( 1. / res.score, res);
+        if (pruned_v[pair_index]) continue;
+      }
 
-        FLASH_DEBUG() << "Candidate Match: "
+      // Else we store this match
+      if(_store_full) {
+        _res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
+        _res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
+      }
+      // For ordering purpose, take an inverse of the score for sorting
+      score_map.emplace( 1. / res.score, res);
+
+      FLASH_DEBUG() << "Candidate Match: "
 		      << " TPC=" << tpc_index << " (" << tpc.min_x() << " min x)" << " @ " << tpc.time
 		      << " with Flash=" << flash_index << " @ " << flash.time
 		      << " ... Score=" << res.score
 		      << " ... PE=" << flash.TotalPE()
 		      << std::endl;
-      }
     }
 
     // We have a score-ordered list of match information at this point.
     // Prepare return match information by respecting a score of each possible match.
+    result = Assign(score_map);
+    for (auto const& match_info : result) {
+      FLASH_INFO () << "Concrete Match: " << " TPC=" << match_info.tpc_id << " Flash=" << match_info.flash_id
+		    << " Score=" << match_info.score
+		    << std::endl;
+    }
+
+    if (_prune_validate && prune) {
+      auto const unpruned_result = Assign(unpruned_score_map);
+      bool same = (unpruned_result.size() == result.size());
+      for (size_t i = 0; same && i < result.size(); ++i) {
+        same = (unpruned_result[i].tpc_id == result[i].tpc_id &&
+                unpruned_result[i].flash_id == result[i].flash_id &&
+                unpruned_result[i].score == result[i].score);
+      }
+      if (!same) {
+        ++_num_prune_mismatch;
+        FLASH_WARNING() << "Pruned matches differ from the unpruned ones!" << std::endl;
+      }
+    }
+
+    // Return result
+    return result;
+
+  }
+
+  std::vector<FlashMatch_t> FlashMatchManager::Assign(const std::multimap<double, FlashMatch_t>& score_map) const
+  {
     // Note _allow_reuse_flash becomes relevant here as well.
+    std::vector<FlashMatch_t> result;
 
     // Create a std::set of tpc/flash IDs to keep track of already-matched tpc/flash input.
     std::set<ID_t> tpc_used, flash_used;
-    result.reserve(tpc_index_v.size());
     // Loop over score map created with matching algorithm
     for (auto& score_info : score_map) {
 
-      auto&       match_info  = score_info.second;   // match information
+      auto const& match_info  = score_info.second;   // match information
       auto const& tpc_index   = match_info.tpc_id;   // matched tpc original id
       auto const& flash_index = match_info.flash_id; // matched flash original id
 
-//      std::cout<<"tpc_index and flash_index : "<<tpc_index<<", "<<flash_index<<std::endl ;
-
       // If this tpc object is already assigned (=better match found), ignore
       if (tpc_used.find(tpc_index) != tpc_used.end()) continue;
 
@@ -281,21 +466,13 @@ namespace flashmatch {
       if (!_allow_reuse_flash && flash_used.find(flash_index) != flash_used.end()) continue;
 
       // Reaching this point means a new match. Yay!
-      FLASH_INFO () << "Concrete Match: " << " TPC=" << tpc_index << " Flash=" << flash_index
-		    << " Score=" << match_info.score
-		    << std::endl;
-
       // Register to a list of a "used" flash and tpc info
       tpc_used.insert(tpc_index);
       flash_used.insert(flash_index);
 
-      // std::move matched info from the map to result vector
       result.emplace_back( match_info );
-
     }
-    // Return result
     return result;
-
   }
 
   void FlashMatchManager::PrintConfig() {
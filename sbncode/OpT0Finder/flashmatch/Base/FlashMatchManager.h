@@ -22,6 +22,7 @@
 #include "BaseProhibitAlgo.h"
 #include "BaseFlashMatch.h"
 #include "BaseFlashHypothesis.h"
+#include <map>
 namespace flashmatch {
   /**
      \class FlashMatchManager
@@ -77,6 +78,32 @@ namespace flashmatch {
     void CanReuseFlash(bool ok=true)
     { _allow_reuse_flash = ok; }
 
+    /// Configuration option: number of threads matching TPC object & flash pairs concurrently.
+    /// Only the parts of the match algorithm that are thread safe overlap: QLLMatch runs its
+    /// Minuit fits, and PhotonLibHypothesis its photon library lookups, one at a time.
+    void SetNumThreads(unsigned int n=1)
+    { _num_threads = n; }
+
+    /**
+       Configuration option: skip the fit of a pair whose score bound (BaseFlashMatch::ScoreBound) \n
+       cannot beat the best match already found for its TPC object. The result is unchanged. \n
+       With validate, the skipped pairs are fit anyway and the results with and without them \n
+       are compared.
+    */
+    void PruneFits(bool ok=true, bool validate=false)
+    { _prune_fits = ok; _prune_validate = validate; }
+
+    /// Number of pairs fit in the last Match call (pruned pairs excluded)
+    size_t NumFits() const { return _num_fits; }
+    /// Number of pairs pruned in the last Match call
+    size_t NumPrunedFits() const { return _num_pruned_fits; }
+    /// Number of pairs fit since construction
+    size_t NumFitsTotal() const { return _num_fits_total; }
+    /// Number of pairs pruned since construction
+    size_t NumPrunedFitsTotal() const { return _num_pruned_fits_total; }
+    /// Number of Match calls in which pruning changed the result (PruneValidate only)
+    size_t NumPruneMismatches() const { return _num_prune_mismatch; }
+
     void PrintConfig();
 
     /// Access to an input: TPC objects in the form of QClusterArray_t
@@ -113,6 +140,9 @@ namespace flashmatch {
 
     void AddCustomAlgo(BaseAlgorithm* alg);
 
+    /// Greedy assignment of the score-ordered matches
+    std::vector<flashmatch::FlashMatch_t> Assign(const std::multimap<double, FlashMatch_t>& score_map) const;
+
     BaseFlashFilter*     _alg_flash_filter;     ///< Flash filter algorithm
     BaseTPCFilter*       _alg_tpc_filter;       ///< TPC filter algorithm
     BaseProhibitAlgo*    _alg_match_prohibit;   ///< Flash matchinig prohibit algorithm
@@ -138,6 +168,16 @@ namespace flashmatch {
     std::string _name;
     /// Request boolean to store full matching result (per Match function call)
     bool _store_full;
+    /// Number of threads to match pairs with (1 => serial)
+    unsigned int _num_threads = 1;
+    /// Skip the fits that cannot change the result
+    bool _prune_fits = false;
+    /// Fit the pruned pairs anyway and check the result is unchanged
+    bool _prune_validate = false;
+    /// Fit and pruning counters
+    size_t _num_fits = 0, _num_pruned_fits = 0;
+    size_t _num_fits_total = 0, _num_pruned_fits_total = 0;
+    size_t _num_prune_mismatch = 0;
     /// Full result container indexed by [tpc][flash]
     std::vector<std::vector<flashmatch::FlashMatch_t> > _res_tpc_flash_v;
     /// Full result container indexed by [flash][tpc]
@@ -0,0 +1,31 @@
+//
+// Convert a ROOT photon library (PhotonLibraryData tree) to the flat binary
+// format that PhotonVisibilityService maps into memory
+//
+// Usage: flatten_photon_library INPUT.root OUTPUT.bin [NVOXELS]
+//
+// NVOXELS defaults to the voxel count of PhotonVisibilityService's voxel
+// definition
+//
+
+#include "flashmatch/Base/FMWKTools/PhotonLibrary.h"
+#include "flashmatch/Base/FMWKTools/PhotonVisibilityService.h"
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char** argv){
+
+  if(argc < 3 || argc > 4) {
+    std::cerr << "Usage: " << argv[0] << " INPUT.root OUTPUT.bin [NVOXELS]" << std::endl;
+    return 1;
+  }
+
+  size_t NVoxels = (argc == 4) ? std::strtoul(argv[3], nullptr, 10)
+    : phot::PhotonVisibilityService::GetME().GetVoxelDef().GetNVoxels();
+
+  phot::PhotonLibrary lib;
+  lib.LoadLibraryFromFile(argv[1], NVoxels);
+  lib.StoreFlatLibraryToFile(argv[2]);
+
+  return 0;
+}
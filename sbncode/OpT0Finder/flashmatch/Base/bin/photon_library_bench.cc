@@ -0,0 +1,96 @@
+//
+// Round trip of a photon library through the ROOT and the flat formats,
+// and the startup time of each: the library is loaded from ROOT, written
+// as a flat file, mapped back, and every visibility is compared. Exits
+// with 1 if any differs, so it also serves as a test of the flat format.
+//
+// Usage: photon_library_bench [INPUT.root NVOXELS]
+//
+// Without arguments, a library with random visibilities in 2e5 voxels and
+// 180 channels (the size of the default voxel definition divided by 10) is
+// written to a temporary ROOT file first
+//
+
+#include "flashmatch/Base/FMWKTools/PhotonLibrary.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+int main(int argc, char** argv){
+
+  if(argc != 1 && argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " [INPUT.root NVOXELS]" << std::endl;
+    return 1;
+  }
+
+  std::string root_file;
+  size_t NVoxels;
+  if(argc == 3) {
+    root_file = argv[1];
+    NVoxels = std::strtoul(argv[2], nullptr, 10);
+  }
+  else {
+    root_file = "photon_library_bench.root";
+    NVoxels = 200000;
+    const size_t NOpChannels = 180;
+
+    // Mostly zero, as far from a PMT, where the ROOT format stores nothing
+    phot::PhotonLibrary lib;
+    lib.CreateEmptyLibrary(NVoxels, NOpChannels);
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<float> vis(0., 1.e-3);
+    for(size_t ivox=0; ivox<NVoxels; ++ivox) {
+      for(size_t ich=0; ich<NOpChannels; ++ich) {
+	if(gen() % 4 == 0) lib.SetCount(ivox, ich, vis(gen));
+      }
+    }
+    lib.StoreLibraryToFile(root_file);
+  }
+  const std::string flat_file = root_file + ".flat";
+
+  auto start = std::chrono::steady_clock::now();
+  phot::PhotonLibrary root_lib;
+  root_lib.LoadLibraryFromFile(root_file, NVoxels);
+  std::chrono::duration<double> root_time = std::chrono::steady_clock::now() - start;
+
+  root_lib.StoreFlatLibraryToFile(flat_file);
+
+  if(!phot::PhotonLibrary::IsFlatLibraryFile(flat_file) || phot::PhotonLibrary::IsFlatLibraryFile(root_file)) {
+    std::cerr << "Flat library not recognised" << std::endl;
+    return 1;
+  }
+
+  start = std::chrono::steady_clock::now();
+  phot::PhotonLibrary flat_lib;
+  flat_lib.LoadFlatLibraryFromFile(flat_file, NVoxels);
+  std::chrono::duration<double> map_time = std::chrono::steady_clock::now() - start;
+
+  // Reading every page of the mapping, as a job using the whole library would
+  start = std::chrono::steady_clock::now();
+  size_t ndiff = 0;
+  const phot::PhotonLibraryData root_data = root_lib.GetData();
+  const phot::PhotonLibraryData flat_data = flat_lib.GetData();
+  if(flat_lib.NOpChannels() != root_lib.NOpChannels() || flat_lib.NVoxels() != root_lib.NVoxels()) {
+    std::cerr << "Different library sizes" << std::endl;
+    return 1;
+  }
+  for(size_t ivox=0; ivox<NVoxels; ++ivox) {
+    for(int ich=0; ich<flat_lib.NOpChannels(); ++ich) {
+      if(flat_data[ivox][ich] != root_data[ivox][ich]) ++ndiff;
+    }
+  }
+  std::chrono::duration<double> read_time = std::chrono::steady_clock::now() - start;
+
+  if(argc == 1) std::remove(root_file.c_str());
+  std::remove(flat_file.c_str());
+
+  std::cout << "ROOT library load:        " << root_time.count() << " s" << std::endl
+	    << "flat library mmap:        " << map_time.count() << " s" << std::endl
+	    << "first read of the mmap:   " << read_time.count() << " s (with the comparison)" << std::endl
+	    << ndiff << " visibilities differ" << std::endl;
+
+  return ndiff ? 1 : 0;
+}
@@ -15,6 +15,7 @@
 #include "GeoLineSegment.h"
 #include "GeoAABox.h"
 #include "GeoAlgo.h"
+#include "GeoSlab.h"
 
 //ADD_NEW_HEADER ... do not change this comment line
 
@@ -28,6 +29,8 @@ namespace geoalgo {
   class LineSegment;
   class AABox;
   class GeoAlgo;
+  struct SlabBox;
+  class SegmentArray;
 
   class GeoObjCollection;
 }
@@ -0,0 +1,129 @@
+/**
+ * \file GeoSlab.h
+ *
+ * \ingroup GeoAlgo
+ *
+ * \brief Batched segment & AABox overlap (slab method)
+ *
+ * Header only and independent of the other GeoAlgo classes, so that it can
+ * be used next to either this GeoAlgo or the one from larcorealg.
+ */
+
+/** \addtogroup GeoAlgo
+
+    @{*/
+#ifndef BASICTOOL_GEOSLAB_H
+#define BASICTOOL_GEOSLAB_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace geoalgo {
+
+  /**
+     \class SlabBox
+     Bounds of an axis aligned box, as for AABox::Min() and AABox::Max().
+     The box is closed: points on its faces are contained.
+  */
+  struct SlabBox {
+    double min[3];
+    double max[3];
+
+    SlabBox() : min{0.,0.,0.}, max{0.,0.,0.} {}
+
+    SlabBox(const double x_min, const double y_min, const double z_min,
+	    const double x_max, const double y_max, const double z_max)
+      : min{x_min,y_min,z_min}, max{x_max,y_max,z_max} {}
+  };
+
+  /**
+     \class SegmentArray
+     Line segments stored as a structure of arrays: segment i goes from
+     (x0[i],y0[i],z0[i]) to (x1[i],y1[i],z1[i]).
+  */
+  class SegmentArray {
+  public:
+    std::vector<double> x0, y0, z0;
+    std::vector<double> x1, y1, z1;
+
+    size_t size() const { return x0.size(); }
+
+    void reserve(size_t n)
+    { x0.reserve(n); y0.reserve(n); z0.reserve(n); x1.reserve(n); y1.reserve(n); z1.reserve(n); }
+
+    void clear()
+    { x0.clear(); y0.clear(); z0.clear(); x1.clear(); y1.clear(); z1.clear(); }
+
+    /// Append the segment from (sx,sy,sz) to (ex,ey,ez)
+    void push_back(const double sx, const double sy, const double sz,
+		   const double ex, const double ey, const double ez)
+    {
+      x0.push_back(sx); y0.push_back(sy); z0.push_back(sz);
+      x1.push_back(ex); y1.push_back(ey); z1.push_back(ez);
+    }
+  };
+
+  /// Parametric range [tmin,tmax] of p + t*d within [lo,hi] along one axis.
+  /// Written without branches, and without dividing by 0 for a segment
+  /// parallel to the axis, so that the segment loop vectorizes.
+  inline void _SlabRange_(const double p, const double d, const double lo, const double hi,
+			  double& tmin, double& tmax)
+  {
+    const bool   flat   = (d == 0.);
+    const bool   inside = (lo <= p && p <= hi);
+    const double inv    = 1. / (flat ? 1. : d);
+    const double t1     = (lo - p) * inv;
+    const double t2     = (hi - p) * inv;
+    tmin = std::max(tmin, flat ? (inside ? 0. : 1.) : std::min(t1,t2));
+    tmax = std::min(tmax, flat ? (inside ? 1. : 0.) : std::max(t1,t2));
+  }
+
+  /// Length of the segments inside the box, summed over all of them
+  inline double ContainedLength(const SegmentArray& seg, const SlabBox& box)
+  {
+    const size_t n = seg.size();
+    const double* x0 = seg.x0.data(); const double* y0 = seg.y0.data(); const double* z0 = seg.z0.data();
+    const double* x1 = seg.x1.data(); const double* y1 = seg.y1.data(); const double* z1 = seg.z1.data();
+
+    // Independent partial sums, so that the additions do not serialize the loop
+    const size_t kLanes = 4;
+    double sum[kLanes] = {0.,0.,0.,0.};
+    for(size_t i=0; i<n; i+=kLanes) {
+      for(size_t l=0; l<kLanes; ++l) {
+	const size_t j = std::min(i+l, n-1);
+	const double dx = x1[j]-x0[j], dy = y1[j]-y0[j], dz = z1[j]-z0[j];
+	double tmin = 0., tmax = 1.;
+	_SlabRange_(x0[j], dx, box.min[0], box.max[0], tmin, tmax);
+	_SlabRange_(y0[j], dy, box.min[1], box.max[1], tmin, tmax);
+	_SlabRange_(z0[j], dz, box.min[2], box.max[2], tmin, tmax);
+	const double length = std::sqrt(dx*dx + dy*dy + dz*dz);
+	// the tail of the last block repeats the last segment: do not count it
+	sum[l] += (i+l < n) ? std::max(tmax - tmin, 0.) * length : 0.;
+      }
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  }
+
+  /// Length of the segments inside each of the boxes
+  inline std::vector<double> ContainedLengths(const SegmentArray& seg, const std::vector<SlabBox>& boxes)
+  {
+    std::vector<double> result;
+    result.reserve(boxes.size());
+    for(auto const& box : boxes) result.push_back(ContainedLength(seg, box));
+    return result;
+  }
+
+  /// Length of the segments inside any of the boxes, which must not overlap
+  inline double ContainedLength(const SegmentArray& seg, const std::vector<SlabBox>& boxes)
+  {
+    double length = 0.;
+    for(auto const& box : boxes) length += ContainedLength(seg, box);
+    return length;
+  }
+
+}
+
+#endif
+/** @} */ // end of doxygen group
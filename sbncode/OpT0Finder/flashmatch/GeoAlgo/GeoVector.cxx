@@ -23,6 +23,33 @@ namespace geoalgo {
   Vector::Vector(const TLorentzVector &pt) : Vector(3)
   { (*this)[0] = pt[0]; (*this)[1] = pt[1]; (*this)[2] = pt[2]; }
 
+  void Vector::resize(size_t n, double value) {
+
+    if(n > kFixedSize) {
+      // Moving out of the fixed storage: bring the current components along
+      if(_size <= kFixedSize) _dynamic.assign(_fixed, _fixed + _size);
+      _dynamic.resize(n, value);
+    }
+    else {
+      if(_size > kFixedSize) {
+	for(size_t i=0; i<n; ++i) _fixed[i] = _dynamic[i];
+	std::vector<double>().swap(_dynamic);
+      }
+      for(size_t i=_size; i<n; ++i) _fixed[i] = value;
+    }
+    _size = n;
+  }
+
+  double& Vector::at(size_t i) {
+    if(i >= _size) throw GeoAlgoException("<<at>> index out of range!");
+    return (*this)[i];
+  }
+
+  const double& Vector::at(size_t i) const {
+    if(i >= _size) throw GeoAlgoException("<<at>> index out of range!");
+    return (*this)[i];
+  }
+
   bool Vector::IsValid() const {
     
     for (auto const &v : (*this)){
@@ -18,6 +18,8 @@
 #include "GeoAlgoException.h"
 #include <TVector3.h>
 #include <TLorentzVector.h>
+#include <string>
+#include <vector>
 
 namespace geoalgo {
 
@@ -30,34 +32,72 @@ namespace geoalgo {
 
   /**
      \class Vector
-     This class represents an n-dimensional vector
+     This class represents an n-dimensional vector. \n
+     Up to 3 components are stored in the object itself, so that points,
+     directions and the temporaries of the geometry algorithms (all 2 or 3
+     dimensional) never touch the heap. Only larger vectors keep their
+     components in a std::vector.
   */
-  class Vector : public std::vector<double> {
+  class Vector {
     friend class Trajectory;
     friend class HalfLine;
     friend class LineSegment;
     friend class Sphere;
     friend class GeoAlgo;
   public:
+    /// Number of components stored without a heap allocation
+    static const size_t kFixedSize = 3;
+
+    typedef double        value_type;
+    typedef double*       iterator;
+    typedef const double* const_iterator;
+
     /// Default ctor
-    Vector() : std::vector<double>()
+    Vector() : _size(0), _fixed{0.,0.,0.}
     {}
 
     /// Ctor to instantiate with invalid value
-    Vector(size_t n) : std::vector<double>(n,kINVALID_DOUBLE)
-    {}
+    Vector(size_t n) : Vector()
+    { resize(n,kINVALID_DOUBLE); }
 
     /// Default ctor w/ a bare std::vector<double>
-    Vector(const std::vector<double> &obj) : std::vector<double>(obj)
-    {}
+    Vector(const std::vector<double> &obj) : Vector()
+    { resize(obj.size()); for(size_t i=0; i<_size; ++i) (*this)[i] = obj[i]; }
 
 
     Vector(const double x, const double y);                 ///< ctor w/ x & y
     Vector(const double x, const double y, const double z); ///< ctor w/ x, y & z
     Vector(const TVector3 &pt);                             ///< ctor w/ TVector3
     Vector(const TLorentzVector &pt);                       ///< ctor w/ TLorentzVector
-    
-    virtual ~Vector(){} ///< Default dtor
+
+    //
+    // Container access, as for the std::vector<double> this class used to be
+    //
+    inline size_t size () const { return _size; }
+    inline bool   empty() const { return _size == 0; }
+
+    inline double*       data()       { return _size > kFixedSize ? _dynamic.data() : _fixed; }
+    inline const double* data() const { return _size > kFixedSize ? _dynamic.data() : _fixed; }
+
+    inline double&       operator[](size_t i)       { return data()[i]; }
+    inline const double& operator[](size_t i) const { return data()[i]; }
+    double&       at(size_t i);       ///< Bound-checked access
+    const double& at(size_t i) const; ///< Bound-checked access
+
+    inline iterator       begin()       { return data(); }
+    inline iterator       end  ()       { return data() + _size; }
+    inline const_iterator begin() const { return data(); }
+    inline const_iterator end  () const { return data() + _size; }
+
+    inline double&       front()       { return data()[0]; }
+    inline const double& front() const { return data()[0]; }
+    inline double&       back ()       { return data()[_size-1]; }
+    inline const double& back () const { return data()[_size-1]; }
+
+    /// Change the dimension, new components are set to value
+    void resize(size_t n, double value=0.);
+    void push_back(double value) { resize(_size+1, value); }
+    void clear() { resize(0); }
 
     void   Normalize(); ///< Normalize itself
     bool   IsValid () const; ///< Check if point is valid    
@@ -122,12 +162,6 @@ namespace geoalgo {
       return *this;
     }
 
-    inline Vector& operator=(const Vector& rhs) {
-      this->resize(rhs.size());
-      for(size_t i=0; i<rhs.size(); ++i) (*this)[i]=rhs[i];
-      return (*this);
-    }
-
     inline Vector operator+(const Vector& rhs) const
     { 
       Vector res((*this));
@@ -191,6 +225,11 @@ namespace geoalgo {
     { o << a.dump(); return o; }
     #endif
 
+  private:
+
+    size_t _size;                   ///< Dimension
+    double _fixed[kFixedSize];      ///< Components, if size() <= kFixedSize
+    std::vector<double> _dynamic;   ///< Components, if size() > kFixedSize
   };
 
   /// Point has same feature as Vector
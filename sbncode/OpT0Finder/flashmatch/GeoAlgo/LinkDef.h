@@ -37,6 +37,12 @@
 
 #pragma link C++ class geoalgo::GeoAlgo+;
 #pragma link C++ class geoalgo::GeoObjCollection+;
+#pragma link C++ class geoalgo::SlabBox+;
+#pragma link C++ class std::vector<geoalgo::SlabBox>+;
+#pragma link C++ class geoalgo::SegmentArray+;
+#pragma link C++ function geoalgo::ContainedLength(const geoalgo::SegmentArray&, const geoalgo::SlabBox&);
+#pragma link C++ function geoalgo::ContainedLength(const geoalgo::SegmentArray&, const std::vector<geoalgo::SlabBox>&);
+#pragma link C++ function geoalgo::ContainedLengths(const geoalgo::SegmentArray&, const std::vector<geoalgo::SlabBox>&);
 //ADD_NEW_CLASS ... do not change this line
 
 #endif
@@ -0,0 +1,121 @@
+from test_msg import debug, info, error, warning
+import traceback,sys
+from random import *
+import numpy as np
+from time import *
+from test_import import test_import
+test_import()
+from ROOT import geoalgo, std
+
+_epsilon = 1E-6
+
+# colors
+OK = '\033[92m'
+NO = '\033[91m'
+BLUE = '\033[94m'
+ENDC = '\033[0m'
+
+def length_in_box(iAlgo, box, s, e):
+    # reference answer from the point-by-point GeoAlgo functions
+    start = geoalgo.Vector(s[0],s[1],s[2])
+    end   = geoalgo.Vector(e[0],e[1],e[2])
+    n_contained = box.Contain(start) + box.Contain(end)
+    if n_contained == 2: return start.Dist(end)
+    xs = iAlgo.Intersection(geoalgo.LineSegment(start,end),box)
+    if n_contained == 1:
+        inside = start if box.Contain(start) else end
+        return inside.Dist(xs[0])
+    if xs.size() == 2: return xs[0].Dist(xs[1])
+    return 0.
+
+def test_slab():
+
+    debug()
+    debug(BLUE + "Precision Being Required to Consider Two numbers Equal: {0:.2e}".format(_epsilon) + ENDC)
+    debug()
+
+    # number of times to test each function
+    tests = 10000
+
+    iAlgo = geoalgo.GeoAlgo()
+
+    try:
+
+        info('Testing LineSegment & AABox Contained Length (Single Segment)')
+        totSuccess = 0
+        slabT = 0.
+        for y in range(tests):
+            # unit cube, and segments starting and ending in and around it
+            box  = geoalgo.AABox(0,0,0,1,1,1)
+            sbox = geoalgo.SlabBox(0,0,0,1,1,1)
+            s = [3*random()-1 for x in range(3)]
+            e = [3*random()-1 for x in range(3)]
+            seg = geoalgo.SegmentArray()
+            seg.push_back(s[0],s[1],s[2],e[0],e[1],e[2])
+            answer = length_in_box(iAlgo,box,s,e)
+            tim = time()
+            a1 = geoalgo.ContainedLength(seg,sbox)
+            slabT += (time() - tim)
+            if ( np.abs(answer-a1) < _epsilon ): totSuccess += 1
+        if ( float(totSuccess)/tests < 0.999):
+            info(NO + "Success: {0}%".format(100*float(totSuccess)/tests) + ENDC)
+            raise Exception
+        else:
+            info(OK + "Success: {0}%".format(100*float(totSuccess)/tests) + ENDC)
+        info("Time for ContainedLength               : {0:.3f} us".format(1E6*slabT/tests))
+
+        info('Testing Segments Parallel To & On Faces Of AABox')
+        sbox = geoalgo.SlabBox(0,0,0,1,1,1)
+        seg = geoalgo.SegmentArray()
+        # along x inside the box, on the y=1 face, outside of the box and a point
+        seg.push_back(-1,0.5,0.5,2,0.5,0.5)
+        seg.push_back(0.2,1,0.5,0.7,1,0.5)
+        seg.push_back(-1,1.5,0.5,2,1.5,0.5)
+        seg.push_back(0.5,0.5,0.5,0.5,0.5,0.5)
+        answer = 1. + 0.5
+        if not ( np.abs(geoalgo.ContainedLength(seg,sbox)-answer) < _epsilon ):
+            info(NO + "Wrong length for axis parallel segments" + ENDC)
+            raise Exception
+
+        info('Testing Trajectory & Several AABox Contained Lengths')
+        totSuccess = 0
+        ntraj = tests // 100
+        for y in range(ntraj):
+            success = 1
+            # two boxes side by side along x and one apart
+            boxes = [geoalgo.AABox(0,0,0,1,1,1), geoalgo.AABox(1,0,0,2,1,1), geoalgo.AABox(3,0,0,4,1,1)]
+            sboxes = std.vector('geoalgo::SlabBox')()
+            for b in boxes:
+                sboxes.push_back(geoalgo.SlabBox(b.Min()[0],b.Min()[1],b.Min()[2],b.Max()[0],b.Max()[1],b.Max()[2]))
+            # random walk through them
+            pts = [[5*random()-0.5, random(), random()]]
+            for x in range(100):
+                pts.append([pts[-1][i] + 0.2*(random()-0.5) for i in range(3)])
+            seg = geoalgo.SegmentArray()
+            seg.reserve(len(pts)-1)
+            answers = [0.]*len(boxes)
+            for i in range(len(pts)-1):
+                seg.push_back(pts[i][0],pts[i][1],pts[i][2],pts[i+1][0],pts[i+1][1],pts[i+1][2])
+                for b in range(len(boxes)):
+                    answers[b] += length_in_box(iAlgo,boxes[b],pts[i],pts[i+1])
+            lengths = geoalgo.ContainedLengths(seg,sboxes)
+            for b in range(len(boxes)):
+                if not ( np.abs(answers[b]-lengths[b]) < _epsilon ): success = 0
+            if not ( np.abs(sum(answers)-geoalgo.ContainedLength(seg,sboxes)) < _epsilon ): success = 0
+            totSuccess += success
+        if ( float(totSuccess)/ntraj < 0.99):
+            info(NO + "Success: {0}%".format(100*float(totSuccess)/ntraj) + ENDC)
+            raise Exception
+        else:
+            info(OK + "Success: {0}%".format(100*float(totSuccess)/ntraj) + ENDC)
+
+    except Exception:
+        error('geoalgo::ContainedLength unit test failed.')
+        print(traceback.format_exception(*sys.exc_info())[2])
+        return 1
+
+    info('geoalgo::ContainedLength unit test complete.')
+    return 0
+
+if __name__ == '__main__':
+    test_slab()
@@ -26,3 +26,9 @@ if test_vector(): sys.exit(1)
 #
 from test_distance import test_dAlgo
 if test_dAlgo(): sys.exit(1)
+
+#
+# Test ContainedLength
+#
+from test_slab import test_slab
+if test_slab(): sys.exit(1)
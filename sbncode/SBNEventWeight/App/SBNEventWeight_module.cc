@@ -27,6 +27,7 @@
 #include "sbnobj/Common/SBNEventWeight/EventWeightMap.h"
 #include "sbnobj/Common/SBNEventWeight/EventWeightParameterSet.h"
 #include "sbncode/SBNEventWeight/Base/WeightManager.h"
+#include "sbncode/SBNEventWeight/Base/WeightCompression.h"
 
 #include "canvas/Persistency/Common/Assns.h"
 #include "art/Framework/Principal/Run.h"
@@ -46,18 +47,21 @@ public:
 private:
   void produce(art::Event& e) override;
   void beginRun(art::Run& run) override;
+  void endJob() override;
 
 private:
   WeightManager fWeightManager;
   std::string fGenieModuleLabel;
   bool fAllowMissingTruth;
+  bool fQuantizeWeights;
 };
 
 
 SBNEventWeight::SBNEventWeight(fhicl::ParameterSet const& p)
   : EDProducer{p},
   fGenieModuleLabel(p.get<std::string>("generator_module_label", "generator")),
-  fAllowMissingTruth(p.get<bool>("AllowMissingTruth"))
+  fAllowMissingTruth(p.get<bool>("AllowMissingTruth")),
+  fQuantizeWeights(p.get<bool>("QuantizeWeights", false))
 {
   const size_t n_func = fWeightManager.Configure(p,
                                                  [this](std::string const& type, std::string const& instance) -> auto&
@@ -87,12 +91,18 @@ void SBNEventWeight::produce(art::Event& e) {
   if(mcTruthHandle.isValid() || !fAllowMissingTruth){
     art::fill_ptr_vector(mclist, mcTruthHandle);
 
-    // Loop over all truth objects (e.g. neutrinos) in this event
-    for (size_t i=0; i<mclist.size(); i++) {
-      const EventWeightMap mcwgh = fWeightManager.Run(e, i);
-      mcwghvec->push_back(std::move(mcwgh));
+    // Weights for all truth objects (e.g. neutrinos) in this event
+    *mcwghvec = fWeightManager.RunAll(e, mclist.size());
+
+    // Half precision weights, see WeightCompression.h for the error
+    if (fQuantizeWeights) {
+      for (auto& wghmap : *mcwghvec) {
+        for (auto& it : wghmap) QuantizeWeights(it.second);
+      }
+    }
 
-      art::Ptr<sbn::evwgh::EventWeightMap> wghPtr = makeWeightPtr(mcwghvec->size() - 1);
+    for (size_t i=0; i<mclist.size(); i++) {
+      art::Ptr<sbn::evwgh::EventWeightMap> wghPtr = makeWeightPtr(i);
       wghassns->addSingle(mclist.at(i), wghPtr);
     }
   }
@@ -112,6 +122,11 @@ void SBNEventWeight::beginRun(art::Run& run) {
   run.put(std::move(p), art::fullRun());
 }
 
+
+void SBNEventWeight::endJob() {
+  fWeightManager.PrintTimingReport();
+}
+
   }  // namespace evwgh
 }  // namespace sbn
 
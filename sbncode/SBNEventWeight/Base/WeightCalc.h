@@ -11,6 +11,7 @@
 #include "TMatrixD.h"
 #include "CLHEP/Random/RandGaussQ.h"
 #include "sbnobj/Common/SBNEventWeight/EventWeightParameterSet.h"
+#include "WeightContext.h"
 
 namespace fhicl { class ParameterSet; }
 
@@ -24,7 +25,10 @@ public:
   virtual void Configure(fhicl::ParameterSet const& pset,
                          CLHEP::HepRandomEngine&) = 0;
 
-  virtual std::vector<float> GetWeight(art::Event& e, size_t inu) = 0;
+  /// Weights of all the universes for the neutrino ctx.Index() of
+  /// ctx.Event(). Objects built from the event that other calculators also
+  /// need can be shared through the context.
+  virtual std::vector<float> GetWeight(WeightContext& ctx) = 0;
 
   void SetName(std::string name) { fName = name; }
   void SetType(std::string type) { fType = type; }
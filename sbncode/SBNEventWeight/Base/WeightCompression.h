@@ -0,0 +1,68 @@
+#ifndef _SBN_WEIGHTCOMPRESSION_H_
+#define _SBN_WEIGHTCOMPRESSION_H_
+
+/**
+ * \file WeightCompression.h
+ * \brief Cheaper storage of the weights of the universes
+ *
+ * Header only, so that the CAF maker can use it without linking to the
+ * EventWeight libraries.
+ *
+ * AllOnes() tells whether a calculator gave weight 1 in all its universes.
+ * The flux calculators do that for every neutrino whose parent they do not
+ * reweight. The CAF maker can store them as a single weight of 1, which
+ * readers must then take as the weight of all the nuniv universes (of the
+ * parameter set in SRGlobal). An empty vector cannot be used for this: some
+ * calculators legitimately return no weights.
+ *
+ * QuantizeWeight() rounds a weight to the nearest IEEE 754 half precision
+ * (16 bit) value, so that the 13 lowest bits of its float significand are
+ * 0 and the stored weights compress much better. The error is at most:
+ *  - 2^-11 (4.9e-4) relative, for weights from 2^-14 (6.1e-5) to 65504;
+ *  - 2^-25 (3.0e-8) absolute, for weights below 2^-14.
+ * Weights above 65504, and those that are not finite, are kept as they are.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace sbn {
+  namespace evwgh {
+
+/// Whether there are weights, and all of them are 1
+inline bool AllOnes(std::vector<float> const& weights) {
+  return !weights.empty() &&
+    std::all_of(weights.begin(), weights.end(), [](float w) { return w == 1.f; });
+}
+
+/// The half precision value closest to this weight (see above)
+inline float QuantizeWeight(float w) {
+  constexpr float kHalfMax = 65504.f;
+  constexpr float kHalfMinNormal = 6.103515625e-05f;   // 2^-14
+  constexpr float kHalfStep = 5.9604644775390625e-08f; // 2^-24, between subnormal half values
+
+  const float a = std::fabs(w);
+  if (!(a <= kHalfMax)) return w;
+  if (a < kHalfMinNormal) return std::nearbyint(w / kHalfStep) * kHalfStep;
+
+  // Keep 10 of the 23 bits of the significand, rounding to the nearest
+  // (even on ties). A carry goes into the exponent, as it should.
+  std::uint32_t bits;
+  std::memcpy(&bits, &w, sizeof bits);
+  bits += 0xFFFu + ((bits >> 13) & 1u);
+  bits &= ~std::uint32_t(0x1FFFu);
+  std::memcpy(&w, &bits, sizeof bits);
+  return w;
+}
+
+inline void QuantizeWeights(std::vector<float>& weights) {
+  for (float& w : weights) w = QuantizeWeight(w);
+}
+
+  }  // namespace evwgh
+}  // namespace sbn
+
+#endif  // _SBN_WEIGHTCOMPRESSION_H_
@@ -0,0 +1,83 @@
+#ifndef _SBN_WEIGHTCONTEXT_H_
+#define _SBN_WEIGHTCONTEXT_H_
+
+/**
+ * \file WeightContext.h
+ * \brief What the weight calculators are given for one neutrino of an event
+ *
+ * Besides the event and the index of the neutrino, the context keeps the
+ * objects that several calculators would otherwise each rebuild from the
+ * event (for instance the GENIE event record of the neutrino), for as long
+ * as WeightManager::Run (or RunAll) takes.
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include "art/Framework/Principal/fwd.h"
+#include "cetlib_except/exception.h"
+
+namespace sbn {
+  namespace evwgh {
+
+class WeightContext {
+public:
+  /**
+   * @param e the art event
+   * @param inu the index of the simulated neutrino in the event
+   */
+  WeightContext(art::Event& e, size_t inu)
+    : fEvent(e), fIndex(inu) {}
+
+  WeightContext(WeightContext const&) = delete;
+  WeightContext& operator=(WeightContext const&) = delete;
+
+  art::Event& Event() const { return fEvent; }
+  size_t Index() const { return fIndex; }
+
+  /**
+   * Returns the object cached under this key, calling make() to create it
+   * the first time it is requested. Safe to call from concurrent
+   * calculators: only one of them creates the object.
+   *
+   * @param key name of the object, unique among the calculators using it
+   * @param make callable returning a std::unique_ptr<T> to the new object
+   */
+  template <typename T, typename Maker>
+  T& Get(std::string const& key, Maker make);
+
+private:
+  struct Entry {
+    std::type_index type;
+    std::shared_ptr<void> object;
+  };
+
+  art::Event& fEvent;
+  size_t fIndex;
+  std::mutex fCacheMutex;
+  std::map<std::string, Entry> fCache;
+};
+
+
+template <typename T, typename Maker>
+T& WeightContext::Get(std::string const& key, Maker make) {
+  std::lock_guard<std::mutex> lock(fCacheMutex);
+  auto it = fCache.find(key);
+  if (it == fCache.end()) {
+    std::shared_ptr<T> object(make());
+    it = fCache.emplace(key, Entry{ std::type_index(typeid(T)), object }).first;
+  }
+  else if (it->second.type != std::type_index(typeid(T))) {
+    throw cet::exception(__PRETTY_FUNCTION__) << "Object " << key
+      << " was cached with a different type" << std::endl;
+  }
+  return *static_cast<T*>(it->second.object.get());
+}
+
+  }  // namespace evwgh
+}  // namespace sbn
+
+#endif  // _SBN_WEIGHTCONTEXT_H_
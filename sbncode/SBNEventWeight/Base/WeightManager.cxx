@@ -1,16 +1,37 @@
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
 #include "sbnobj/Common/SBNEventWeight/EventWeightMap.h"
 #include "WeightManager.h"
 
 namespace sbn {
   namespace evwgh {
 
+std::vector<float> WeightManager::RunCalc(WeightCalc* calc, CalcTiming& timing, WeightContext& ctx) {
+  auto const start = std::chrono::steady_clock::now();
+  std::vector<float> weights = calc->GetWeight(ctx);
+  std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+  timing.nCalls++;
+  timing.nWeights += weights.size();
+  timing.seconds += elapsed.count();
+
+  return weights;
+}
+
+
 EventWeightMap WeightManager::Run(art::Event& e, const int inu) {
   EventWeightMap mcwgh;
 
+  // Shared by all the calculators for this neutrino only
+  WeightContext ctx(e, inu);
+
   for (auto it=fWeightCalcMap.begin(); it!=fWeightCalcMap.end(); ++it) {
-    const std::vector<float>& weights = it->second->GetWeight(e, inu);
+    const std::vector<float>& weights = RunCalc(it->second, fCalcTiming.at(it->first), ctx);
     std::string wname = it->first + "_" + it->second->GetType();
     mcwgh.insert({ wname, weights });
   }
@@ -18,6 +39,64 @@ EventWeightMap WeightManager::Run(art::Event& e, const int inu) {
   return mcwgh;
 }
 
+
+std::vector<EventWeightMap> WeightManager::RunAll(art::Event& e, size_t n_nu) {
+  if (!fParallelCalculators) {
+    std::vector<EventWeightMap> mcwgh;
+    for (size_t inu = 0; inu < n_nu; inu++) mcwgh.push_back(Run(e, inu));
+    return mcwgh;
+  }
+
+  // One context per neutrino, shared by the calculators running at the same time
+  std::vector<std::unique_ptr<WeightContext>> contexts;
+  for (size_t inu = 0; inu < n_nu; inu++)
+    contexts.push_back(std::make_unique<WeightContext>(e, inu));
+
+  // Everything the tasks touch is looked up beforehand: each task then
+  // only writes to its own timing and its own row of weights
+  std::vector<WeightCalc*> calcs;
+  std::vector<CalcTiming*> timings;
+  std::vector<std::string> wnames;
+  for (auto const& it : fWeightCalcMap) {
+    calcs.push_back(it.second);
+    timings.push_back(&fCalcTiming.at(it.first));
+    wnames.push_back(it.first + "_" + it.second->GetType());
+  }
+
+  // weights[calculator][neutrino]
+  std::vector<std::vector<std::vector<float>>> weights(calcs.size(), std::vector<std::vector<float>>(n_nu));
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, calcs.size(), 1),
+                    [&](tbb::blocked_range<size_t> const& r) {
+                      for (size_t ic = r.begin(); ic != r.end(); ++ic) {
+                        for (size_t inu = 0; inu < n_nu; inu++)
+                          weights[ic][inu] = RunCalc(calcs[ic], *timings[ic], *contexts[inu]);
+                      }
+                    });
+
+  // Filled in the same order as Run does, whichever task finished first
+  std::vector<EventWeightMap> mcwgh(n_nu);
+  for (size_t inu = 0; inu < n_nu; inu++) {
+    for (size_t ic = 0; ic < calcs.size(); ic++)
+      mcwgh[inu].insert({ wnames[ic], std::move(weights[ic][inu]) });
+  }
+
+  return mcwgh;
+}
+
+
+void WeightManager::PrintTimingReport() const {
+  mf::LogInfo log("SBNEventWeight");
+  log << "Weight calculator timing:";
+  for (auto const& it : fCalcTiming) {
+    CalcTiming const& timing = it.second;
+    log << "\n  " << it.first << ": " << timing.nCalls << " calls, "
+        << timing.nWeights << " universes in " << timing.seconds << " s";
+    if (timing.seconds > 0.)
+      log << " (" << timing.nWeights / timing.seconds << " universes/s)";
+  }
+}
+
   }  // namespace evwgh
 }  // namespace sbn
 
@@ -44,7 +44,8 @@ public:
    * WeightManager::Configure needs to be called first \n
    *
    * 0) Loos over all the previously emplaced calculators \n
-   * 1) For each of them calculates the weights (more weight can be requested per calculator) \n
+   * 1) For each of them calculates the weights (more weight can be requested per calculator). \n
+   *    All of them are given the same WeightContext, so what they rebuild from the event is done once \n
    * 3) Returns a map from "calculator name" to vector of weights calculated which is available inside EventWeightMap
    *
    * @param e the art event
@@ -52,13 +53,45 @@ public:
    */
   EventWeightMap Run(art::Event &e, const int inu);
 
+  /**
+   * Assigns the weights of all the neutrinos in the event: returns the same
+   * maps as calling WeightManager::Run for each neutrino in turn. \n
+   * If the parallel_calculators fcl parameter is set, the calculators run as
+   * concurrent tasks, each one going through the neutrinos in order (a
+   * calculator is never run on two neutrinos at the same time). GENIE is
+   * not thread safe, so the GENIE calculators still run one at a time:
+   * only the other calculators overlap with them and with each other.
+   *
+   * @param e the art event
+   * @param n_nu the number of simulated neutrinos in the event
+   */
+  std::vector<EventWeightMap> RunAll(art::Event &e, size_t n_nu);
+
   /**
    * Returns the map between calculator name and WeightCalcs
    */
   std::map<std::string, WeightCalc*> GetWeightCalcMap() { return fWeightCalcMap; }
 
+  /**
+   * Logs, for each calculator, the time spent in WeightManager::Run and the
+   * number of universes (weights) it computed per second
+   */
+  void PrintTimingReport() const;
+
 private:
+  /// Time spent by one calculator, summed over the calls to Run
+  struct CalcTiming {
+    size_t nCalls = 0;
+    size_t nWeights = 0;
+    double seconds = 0.;
+  };
+
+  /// Runs one calculator on the neutrino of the context, and times it
+  std::vector<float> RunCalc(WeightCalc* calc, CalcTiming& timing, WeightContext& ctx);
+
   std::map<std::string, WeightCalc*> fWeightCalcMap;  ///< A set of custom weight calculators
+  std::map<std::string, CalcTiming> fCalcTiming;      ///< Same keys as fWeightCalcMap
+  bool fParallelCalculators = false;                  ///< Whether RunAll runs the calculators concurrently
 };
 
 
@@ -69,6 +102,7 @@ size_t WeightManager::Configure(fhicl::ParameterSet const& p, EngineCreator crea
   // Get list of weight functions
   auto const rw_func = p.get<std::vector<std::string> >("weight_functions");
   auto const module_label = p.get<std::string>("module_label");
+  fParallelCalculators = p.get<bool>("parallel_calculators", false);
 
   // Loop over all the functions and register them
   for (auto const& func : rw_func) {
@@ -91,6 +125,7 @@ size_t WeightManager::Configure(fhicl::ParameterSet const& p, EngineCreator crea
     wcalc->Configure(p, engine);
 
     fWeightCalcMap.emplace(func, wcalc);
+    fCalcTiming.emplace(func, CalcTiming());
   }
 
   return fWeightCalcMap.size();
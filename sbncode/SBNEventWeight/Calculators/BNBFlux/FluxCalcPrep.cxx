@@ -169,6 +169,9 @@ namespace sbn {
             TArrayD* HARPthetaBoundsArray = (TArrayD*) file->Get(pname[3].c_str());
             HARPthetaBounds = FluxWeightCalc::ConvertToVector(HARPthetaBoundsArray);
 
+            fMomentumBasis = FluxWeightCalc::SplineBasis(HARPmomentumBounds);
+            fThetaBasis = FluxWeightCalc::SplineBasis(HARPthetaBounds);
+
             /////////////////
             //
             //   Extract the Sanford-Wang Fit Parmeters
@@ -203,12 +206,43 @@ namespace sbn {
 
         }//end of special Hadron calculator configurations
 
+        //Parameters of each universe; in GetWeight() only the kinematics are left to do
+        if(fParameterSet.fRWType == EventWeightParameterSet::kMultisim){
+          int NUni = fParameterSet.fNuniverses;
+          std::vector< float > const& Vrandom = (fParameterSet.fParameterMap.begin())->second;//vector of random #
+          size_t Nrand = ( CalcType == "PrimaryHadronNormalization" )? 1 : FitCov->GetNcols();//random # per universe
+
+          int NAccepted = 0;
+          fUniverseParams.clear();
+          for (size_t i = 0; NAccepted < NUni; i++) {//skip the universes with unphysical parameters
+            if( (i+1)*Nrand > Vrandom.size() ){
+              throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": "
+                << "only " << NAccepted << " of the " << NUni
+                << " universes have physical parameters" << std::endl;
+            }
+            std::vector< float > subVrandom(Vrandom.begin()+i*Nrand, Vrandom.begin()+(i+1)*Nrand);//sub-vector of random numbers;
+            std::vector< double > param;
+            bool pass = false;
+            if( CalcType == "PrimaryHadronNormalization") pass = PHNUniverse(subVrandom, param);
+            else if( CalcType == "PrimaryHadronFeynmanScaling") pass = PHFSUniverse(subVrandom, param);
+            else if( CalcType == "PrimaryHadronSanfordWang") pass = PHSWUniverse(subVrandom, param);
+            else if( CalcType == "PrimaryHadronSWCentralSplineVariation") pass = PHSWCSVUniverse(subVrandom, param);
+
+            if(!pass) continue;
+            fNUniverseParams = param.size();
+            fUniverseParams.insert(fUniverseParams.end(), param.begin(), param.end());
+            NAccepted++;
+          }
+        }
+
       } else  validC = false; //the calculator name is way too off.
 //      std::cout<<"SBNEventWeight : finish configuration."<<std::endl;
     }//End of Configure() function
 
 
-    std::vector<float> FluxWeightCalc::GetWeight(art::Event& e, size_t inu) {
+    std::vector<float> FluxWeightCalc::GetWeight(WeightContext& ctx) {
+      art::Event& e = ctx.Event();
+      size_t inu = ctx.Index();
       bool count_weights = false;
 //      std::cout<<"SBNEventWeight : getweight for the "<<inu<<" th particles of an event"<< std::endl;
       //MCFlux & MCTruth
@@ -295,49 +329,36 @@ namespace sbn {
 
         if(fParameterSet.fRWType == EventWeightParameterSet::kMultisim){
 
-          for (unsigned int i = 0; int(weights.size()) < NUni; i++) {//if all weights are 1, no need to calculate weights;
-            std::pair<bool, double> test_weight;
-
-            std::vector< float > Vrandom = (fParameterSet.fParameterMap.begin())->second;//vector of random #
-            std::vector< float > subVrandom;//sub-vector of random numbers;
-            if( CalcType == "PrimaryHadronNormalization"){//Normalization
-              test_weight = PHNWeightCalc(fluxlist[inu], Vrandom[i]);
-
-            } else {
-              subVrandom = {Vrandom.begin()+i*FitCov->GetNcols(), Vrandom.begin()+(i+1)*FitCov->GetNcols()};
-              if( CalcType == "PrimaryHadronFeynmanScaling"){//FeynmanScaling
-                test_weight = PHFSWeightCalc(fluxlist[inu], subVrandom);
-
-              } else if( CalcType == "PrimaryHadronSanfordWang"){//SanfordWang
-                test_weight = PHSWWeightCalc(fluxlist[inu], subVrandom);
-
-              } else if( CalcType == "PrimaryHadronSWCentralSplineVariation"){//SWCentaralSplineVariation
-                test_weight = PHSWCSVWeightCalc(fluxlist[inu], subVrandom);
-
-              } else throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": this shouldnt happen.."<<std::endl;
-            }
-
-            if(test_weight.first){  
-              weights.push_back(test_weight.second);
-              double tmp_weight = test_weight.second;
-//              std::cout<<i<<" ("<<tmp_weight<<") ";
-        if(count_weights){
-          if(tmp_weight<0){
-            wcn++;
-          }else if((tmp_weight-0)<1e-30){
-            wc0++;
-          }else if(fabs(tmp_weight-30) < 1e-30){
-            wc30++;
-          } else if(fabs(tmp_weight-1)<1e-30){
-            wc1++;
-          } else {
-            wc++;
+          weights.resize(NUni);
+          if( CalcType == "PrimaryHadronNormalization"){//Normalization
+            PHNWeightCalc(fluxlist[inu], weights);
+
+          } else if( CalcType == "PrimaryHadronFeynmanScaling"){//FeynmanScaling
+            PHFSWeightCalc(fluxlist[inu], weights);
+
+          } else if( CalcType == "PrimaryHadronSanfordWang"){//SanfordWang
+            PHSWWeightCalc(fluxlist[inu], weights);
+
+          } else if( CalcType == "PrimaryHadronSWCentralSplineVariation"){//SWCentaralSplineVariation
+            PHSWCSVWeightCalc(fluxlist[inu], weights);
+
+          } else throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": this shouldnt happen.."<<std::endl;
+
+          if(count_weights){
+            for (double tmp_weight : weights) {
+              if(tmp_weight<0){
+                wcn++;
+              }else if((tmp_weight-0)<1e-30){
+                wc0++;
+              }else if(fabs(tmp_weight-30) < 1e-30){
+                wc30++;
+              } else if(fabs(tmp_weight-1)<1e-30){
+                wc1++;
+              } else {
+                wc++;
+              }
+            }//Iterate through the number of universes
           }
-        }
-
-            };
-
-          }//Iterate through the number of universes      
         }//Yes, Multisim
       }
 
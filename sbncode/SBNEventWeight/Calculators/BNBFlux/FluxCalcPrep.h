@@ -13,6 +13,7 @@
 //#include <sys/stat.h> //for exit(0); debugging purpose
 
 #include "TH1F.h"
+#include "TSpline.h"
 #include "TFile.h"
 #include "TDecompChol.h"//for Choleskey Decomposition
 
@@ -30,8 +31,8 @@ namespace sbn {
 
         //GetWeight() returns the final weights as a vector
         //  each weight evaluaed by *WeightCalc() function;
-        //inu - the ith parameter.
-        std::vector<float> GetWeight(art::Event& e, size_t inu) override;
+        //ctx - the event and the index of the neutrino in it.
+        std::vector<float> GetWeight(WeightContext& ctx) override;
 
         //UnisimWeightCalc() - Function for evaluating a specific weight
         //enu - neutrino energy from simb::MCTruth; 
@@ -40,16 +41,32 @@ namespace sbn {
         //randomN - input randmo number
         //noNeg - determine what formulas to use for weights depending on input histograms.
 
-        //4 *WeightCalc() functions
+        //5 *WeightCalc() functions
         double UnisimWeightCalc(double enu, int ptype, int ntype, double randomN, bool noNeg);//Unisim
-        std::pair<bool, double> PHNWeightCalc  (simb::MCFlux flux, float rand);//PrimaryHadronNormalizationWeightCalc
-        std::pair<bool, double> PHFSWeightCalc  (simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronFeynmanScaling
-        std::pair<bool, double> PHSWWeightCalc  (simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronSanfordWangWeightCalc
-        std::pair<bool, double> PHSWCSVWeightCalc(simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronSWCentralSplineVariationWeightCalc
-        
+
+        //Hadron production: the random numbers of a universe only change its
+        //  parameters, so those are computed once in Configure() by PH*Universe(),
+        //  which returns false for unphysical parameters (the universe is then skipped).
+        //PH*WeightCalc() fill the weights of all universes for one neutrino.
+        //rand - the random numbers of one universe
+        //param - the parameters of the universe, stored in fUniverseParams
+        bool PHNUniverse  (std::vector<float> const& rand, std::vector<double>& param);//PrimaryHadronNormalizationWeightCalc
+        bool PHFSUniverse  (std::vector<float> const& rand, std::vector<double>& param);//PrimaryHadronFeynmanScaling
+        bool PHSWUniverse  (std::vector<float> const& rand, std::vector<double>& param);//PrimaryHadronSanfordWangWeightCalc
+        bool PHSWCSVUniverse(std::vector<float> const& rand, std::vector<double>& param);//PrimaryHadronSWCentralSplineVariationWeightCalc
+
+        void PHNWeightCalc  (simb::MCFlux const& flux, std::vector<float>& weights);
+        void PHFSWeightCalc  (simb::MCFlux const& flux, std::vector<float>& weights);
+        void PHSWWeightCalc  (simb::MCFlux const& flux, std::vector<float>& weights);
+        void PHSWCSVWeightCalc(simb::MCFlux const& flux, std::vector<float>& weights);
+
         //Handy tool
         std::vector<double> ConvertToVector(TArrayD const* array);
 
+        //Splines through the centers of the bins, with 1 in one bin and 0 elsewhere
+        //  (one per bin); see PrimaryHadronSWCentralSplineVariationWeightCalc.cxx
+        std::vector<TSpline3> SplineBasis(std::vector<double> const& bounds);
+
       private:
         //fParameterSet was prepared in `sbncode/Base/WeightManager.h`
         std::string fGeneratorModuleLabel;
@@ -77,6 +94,13 @@ namespace sbn {
         std::vector<double> HARPthetaBounds{};
         std::vector<double> SWParam{};
         bool fIsDecomposed{false};
+        std::vector<TSpline3> fMomentumBasis{};
+        std::vector<TSpline3> fThetaBasis{};
+
+        //-- Parameters of the hadron production universes (multisim):
+        //   fNUniverseParams per universe, universe after universe
+        size_t fNUniverseParams{0};
+        std::vector<double> fUniverseParams{};
 
         //Weight Counter
         int wc = 0;
@@ -6,7 +6,23 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHFSWeightCalc(simb::MCFlux flux, std::vector<float> rand){
+    bool FluxWeightCalc::PHFSUniverse(std::vector<float> const& rand, std::vector<double>& param){
+
+      // Define the variations around the central value cross section
+      //    To do this we will call the a function from WeightCalc
+      //    that will generate a set of smeared parameters based 
+      //    on the covariance matrix that we imported
+      param = MultiGaussianSmearing(FitVal, FitCov, rand);//Defined in sbncode/SBNEventWeight/Base/SmearingUtils.h
+
+      // We need to guard against unphysical parameters 
+      return (param.at(0) > 0 && 
+          param.at(1) > 0 && 
+          param.at(2) > 0 && 
+          param.at(4) > 0 && 
+          param.at(6) > 0);
+    }
+
+    void FluxWeightCalc::PHFSWeightCalc(simb::MCFlux const& flux, std::vector<float>& weights){
 
       // 
       //  Largely built off the MiniBooNE code 
@@ -18,9 +34,6 @@ namespace sbn {
       //  JZ (6/2017) : Fixed typo in the E_cm calculation per Mike S. suggestions 
       //   
 
-      // We need to guard against unphysical parameters 
-      bool parameters_pass = false;
-
       // Get Neutrino Parent Kinimatics       
       double HadronMass = 0.4937;
 
@@ -104,60 +117,47 @@ namespace sbn {
 
       if(CV < 0) CV = 0;
       if(fabs(xF) > 1) CV = 0;
-      // Define the variations around that cross section
-      //    To do this we will call the a function from WeightCalc
-      //    that will generate a set of smeared parameters based 
-      //    on the covariance matrix that we imported
-      std::vector< double > FSKPlusFitSmeared = MultiGaussianSmearing(FitVal, FitCov, rand);//Defined in sbncode/SBNEventWeight/Base/SmearingUtils.h
 
-      // Pull out the parameters for the Feynman Scaling 
-      double smeared_c1 = FSKPlusFitSmeared.at(0);     
-      double smeared_c2 = FSKPlusFitSmeared.at(1);     
-      double smeared_c3 = FSKPlusFitSmeared.at(2);     
-      double smeared_c4 = FSKPlusFitSmeared.at(3);     
-      double smeared_c5 = FSKPlusFitSmeared.at(4);     
-      double smeared_c6 = FSKPlusFitSmeared.at(5);     
-      double smeared_c7 = FSKPlusFitSmeared.at(6);     
-
-      if(smeared_c1 > 0 && 
-          smeared_c2 > 0 && 
-          smeared_c3 > 0 && 
-          smeared_c5 > 0 && 
-          smeared_c7 > 0){
-        parameters_pass = true;  
-      }
-
-      double RW = smeared_c1*(HadronVec.P()*HadronVec.P()/HadronE)*exp(-1.*smeared_c3*pow(fabs(xF),smeared_c4) 
-          - smeared_c7*pow(fabs(HadronPT*xF),smeared_c6)
-          - smeared_c2*HadronPT
-          - smeared_c5*HadronPT*HadronPT);
-
-      if(RW < 0) RW = 0;
-      if(fabs(xF) > 1) RW = 0;
-
-      double weight = 1; 
-
-      if(RW < 0 || CV < 0){
-        weight = 1;
-      }
-      else if(CV < 1.e-12){
-        weight = 1;
-      }
-      else{
-        weight *= RW/CV;
-      }
-
-      if(weight < 0) weight = 0;
-      if(weight > 30) weight = 30;
-      if(!(std::isfinite(weight))){
-        std::cout << "FS : Failed to get a finite weight" << std::endl; 
-        weight = 30;}
-
-      std::pair<bool, double> output(parameters_pass, weight);
-
-
-
-      return output; 
+      for(size_t i = 0; i < weights.size(); i++){
+        // Pull out the smeared parameters of this universe (PHFSUniverse())
+        const double* FSKPlusFitSmeared = &fUniverseParams[i*fNUniverseParams];
+        double smeared_c1 = FSKPlusFitSmeared[0];     
+        double smeared_c2 = FSKPlusFitSmeared[1];     
+        double smeared_c3 = FSKPlusFitSmeared[2];     
+        double smeared_c4 = FSKPlusFitSmeared[3];     
+        double smeared_c5 = FSKPlusFitSmeared[4];     
+        double smeared_c6 = FSKPlusFitSmeared[5];     
+        double smeared_c7 = FSKPlusFitSmeared[6];     
+
+        double RW = smeared_c1*(HadronVec.P()*HadronVec.P()/HadronE)*exp(-1.*smeared_c3*pow(fabs(xF),smeared_c4) 
+            - smeared_c7*pow(fabs(HadronPT*xF),smeared_c6)
+            - smeared_c2*HadronPT
+            - smeared_c5*HadronPT*HadronPT);
+
+        if(RW < 0) RW = 0;
+        if(fabs(xF) > 1) RW = 0;
+
+        double weight = 1; 
+
+        if(RW < 0 || CV < 0){
+          weight = 1;
+        }
+        else if(CV < 1.e-12){
+          weight = 1;
+        }
+        else{
+          weight *= RW/CV;
+        }
+
+        if(weight < 0) weight = 0;
+        if(weight > 30) weight = 30;
+        if(!(std::isfinite(weight))){
+          std::cout << "FS : Failed to get a finite weight" << std::endl; 
+          weight = 30;}
+
+        weights[i] = weight;
+
+      }//Iterate through the number of universes
 
     }
 
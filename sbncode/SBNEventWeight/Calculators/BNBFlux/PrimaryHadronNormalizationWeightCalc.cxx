@@ -6,21 +6,28 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHNWeightCalc(simb::MCFlux flux, float rand){
+    bool FluxWeightCalc::PHNUniverse(std::vector<float> const& rand, std::vector<double>& param){
       // We need to guard against unphysical parameters 
       bool parameters_pass = false;
 
-      double weight = rand+1;
+      double weight = rand[0]+1;
 
       if(weight > 0) parameters_pass = true;
       else{parameters_pass = false;}
 
-      std::pair<bool, double> output(parameters_pass, weight);
+      param = {weight};
 
-      return output; 
+      return parameters_pass; 
 
     }
 
+    void FluxWeightCalc::PHNWeightCalc(simb::MCFlux const& flux, std::vector<float>& weights){
+      // The weight of a universe does not depend on the neutrino parent
+      for(size_t i = 0; i < weights.size(); i++){
+        weights[i] = fUniverseParams[i];
+      }
+    }
+
   }  // namespace evwgh
 }  // namespace sbn
 
@@ -7,7 +7,109 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHSWCSVWeightCalc(simb::MCFlux flux, std::vector<float> rand){
+    std::vector<TSpline3> FluxWeightCalc::SplineBasis(std::vector<double> const& bounds){
+
+      int Nbins = int(bounds.size()) - 1;
+
+      std::vector< TSpline3 > basis;
+      basis.resize(Nbins);
+      for(int bin = 0; bin < Nbins; bin++){
+        TH1F unit("HARPbasis",";;;", Nbins, bounds.data());
+        unit.SetDirectory(nullptr);
+        unit.SetBinContent(bin+1, 1);
+        // Important note about Splines, MiniBooNE used constraints on the
+        // second derivative of the first and final knot point and required 
+        // that they both equal to zero, this is not naturally the case in 
+        // in TSpline3 but it is default in DCSPLC (the Fortran CERN library spline function)
+        // this helps to control the smoothness of the spline and minimizes the variation bin to bin
+        // For TSpine3 this is controlled by:
+        //
+        //  b1 = constrain first knot 1st derivative 
+        //  b2 = constrain first knot 2nd derivative 
+        //  e1 = constrain final knot 1st derivative 
+        //  e2 = constrain final knot 2nd derivative 
+        //
+        //  the numbers that follow are the values you constrain those conditions to
+        //
+        basis[bin] = TSpline3(&unit,"b2e2",0,0);
+      }
+
+      return basis;
+    }
+
+
+    bool FluxWeightCalc::PHSWCSVUniverse(std::vector<float> const& rand, std::vector<double>& param){
+
+      bool parameters_pass = true;
+
+      int Ntbins = int(HARPthetaBounds.size()) - 1;
+      int Npbins = int(HARPmomentumBounds.size()) - 1;
+
+      //
+      //  Using the HARP cross section and covariance matrices 
+      //  we will now create variations around the measured HARP
+      //  meson production cross sections. 
+      //
+
+      // Important notes of the HARP data: 
+      //  The cross section matrix has 13 momentum bins and 6 theta bins 
+      //  The covariance matrix contains the correlated uncertainties across
+      //  all 78 cross section measurements. 
+      //
+      //  The covariance matrix encodes the uncertainty on a given HARP 
+      //  ANALYSIS BIN instead of being a 3D matrix. 
+      //
+      //  A HARP analysis bin is defined as 
+      //  bin = momentum[theta[]] meaning that:
+      //      analysis bin 0 is the zeroth theta and zeroth momentum bin
+      //  but analysis bin 27 is the 3rd theta and 5th momentum bin
+      // 
+      // The first thing to do is convert our cross section matrix into 
+      // an std::vector for the analysis bins
+      //
+      std::vector< double > HARPCrossSectionAnalysisBins;
+      HARPCrossSectionAnalysisBins.resize(int(Ntbins*Npbins));
+
+      int anaBin = 0;
+      for(int pbin = 0; pbin < Npbins; pbin++){
+        for(int tbin = 0; tbin < Ntbins; tbin++){  
+          HARPCrossSectionAnalysisBins[anaBin] = HARPXSec[0][pbin][tbin];
+          anaBin++;
+        }
+      }
+
+      //
+      // Now using this we can vary the cross section based on the HARP covariance matrix 
+      // this will allow us to reweigh each cross section measurement based on
+      // the multigaussian smearing of this matrix. 
+      //
+
+      std::vector< double > smearedHARPCrossSectionAnalysisBins = 
+        MultiGaussianSmearing(HARPCrossSectionAnalysisBins, FitCov, fIsDecomposed,rand); 
+
+      //
+      //   Check all the smeared cross sections, if any come out to be negative then 
+      //   we will not pass this given parameter set.
+      //
+
+      for(int check = 0; check < int(smearedHARPCrossSectionAnalysisBins.size()); check++){
+        if(smearedHARPCrossSectionAnalysisBins[check] < 0){ parameters_pass = false;}
+      }
+
+      //
+      // The smeared cross sections of the universe, in analysis bins ([pbin][tbin]).
+      // They used to be splined from TH1F bins, so they keep float precision.
+      //
+      param.resize(smearedHARPCrossSectionAnalysisBins.size());
+      for(anaBin = 0; anaBin < int(param.size()); anaBin++){
+        param[anaBin] = float(smearedHARPCrossSectionAnalysisBins[anaBin]);
+      }
+
+      return parameters_pass;
+    }
+
+
+    void FluxWeightCalc::PHSWCSVWeightCalc(simb::MCFlux const& flux, std::vector<float>& weights){
 
       // 
       //  Largely built off the MiniBooNE code 
@@ -19,8 +121,6 @@ namespace sbn {
       //  JZ (6/2017) : Changed guards on c9 to be double point precision 
       //   
 
-      bool parameters_pass = true;
-
       double c1 = SWParam[0];
       double c2 = SWParam[1];
       double c3 = SWParam[2];
@@ -97,206 +197,83 @@ namespace sbn {
       //
       // Now that we have our central value based on the Sanford-Wang parameterization we 
       // need to create variations around this value. MiniBooNE did this by performing 
-      // spline fits to the HARP data. This is a reproduction of that code:
+      // spline fits to the HARP data: in every universe, a spline over momentum of the
+      // smeared cross section at each theta bin, evaluated at the meson's momentum, then
+      // a spline over theta of those values, evaluated at the meson's theta.
       // 
-      ////
-
-      double* HARPmomentumBins = HARPmomentumBounds.data(); // Convert std::vector to array
-      double* HARPthetaBins = HARPthetaBounds.data();       // Convert std::vector to array
-
-      int Ntbins = int(HARPthetaBounds.size()) - 1;
-      int Npbins = int(HARPmomentumBounds.size()) - 1;
-
-      //
-      //  Using the HARP cross section and covariance matrices 
-      //  we will now create variations around the measured HARP
-      //  meson production cross sections. 
+      // Those splines are linear in the values they go through. So the splines through
+      // a single bin (SplineBasis(), built in Configure()) are evaluated at the meson's
+      // momentum and theta once, and every universe only sums its smeared cross sections
+      // with these coefficients.
       //
+      ////
 
-      // Important notes of the HARP data: 
-      //  The cross section matrix has 13 momentum bins and 6 theta bins 
-      //  The covariance matrix contains the correlated uncertainties across
-      //  all 78 cross section measurements. 
-      //
-      //  The covariance matrix encodes the uncertainty on a given HARP 
-      //  ANALYSIS BIN instead of being a 3D matrix. 
-      //
-      //  A HARP analysis bin is defined as 
-      //  bin = momentum[theta[]] meaning that:
-      //      analysis bin 0 is the zeroth theta and zeroth momentum bin
-      //  but analysis bin 27 is the 3rd theta and 5th momentum bin
-      // 
-      // The first thing to do is convert our cross section matrix into 
-      // an std::vector for the analysis bins
-      //
-      std::vector< double > HARPCrossSectionAnalysisBins;
-      HARPCrossSectionAnalysisBins.resize(int(Ntbins*Npbins));
+      int Ntbins = int(fThetaBasis.size());
+      int Npbins = int(fMomentumBasis.size());
 
-      int anaBin = 0;
+      std::vector< double > MomentumCoeff(Npbins);
       for(int pbin = 0; pbin < Npbins; pbin++){
-        for(int tbin = 0; tbin < Ntbins; tbin++){  
-          HARPCrossSectionAnalysisBins[anaBin] = HARPXSec[0][pbin][tbin];
-          anaBin++;
-        }
+        MomentumCoeff[pbin] = fMomentumBasis[pbin].Eval(HadronVec.P());
       }
 
-      //
-      // Now using this we can vary the cross section based on the HARP covariance matrix 
-      // this will allow us to reweigh each cross section measurement based on
-      // the multigaussian smearing of this matrix. 
-      //
-
-      std::vector< double > smearedHARPCrossSectionAnalysisBins = 
-        MultiGaussianSmearing(HARPCrossSectionAnalysisBins, FitCov, fIsDecomposed,rand); 
-      HARPCrossSectionAnalysisBins.clear();
-
-      //
-      //   Check all the smeared cross sections, if any come out to be negative then 
-      //   we will not pass this given parameter set.
-      //
-
-      for(int check = 0; check < int(smearedHARPCrossSectionAnalysisBins.size()); check++){
-        if(smearedHARPCrossSectionAnalysisBins[check] < 0){ parameters_pass = false;}
+      std::vector< double > ThetaCoeff(Ntbins);
+      for(int tbin = 0; tbin < Ntbins; tbin++){
+        ThetaCoeff[tbin] = fThetaBasis[tbin].Eval(ThetaOfInterest);
       }
 
-      //  
-      // With a checked set of smeared cross sections we can convert our analysis bin
-      // std::vector back into a TMatrixD, though this is a bit annoying since TMatrices 
-      // are an annoying format. 
-      //
-      TMatrixD*  smearedHARPXSec = new TMatrixD(Npbins,Ntbins);
+      for(size_t i = 0; i < weights.size(); i++){
+        // Smeared cross sections of this universe (PHSWCSVUniverse())
+        const double* smearedHARPXSec = &fUniverseParams[i*fNUniverseParams];
 
-      anaBin = 0;
-      for(int pbin = 0; pbin < Npbins; pbin++){
+        double RW = 0;
         for(int tbin = 0; tbin < Ntbins; tbin++){
-          smearedHARPXSec[0][pbin][tbin] = smearedHARPCrossSectionAnalysisBins[anaBin];    
-          anaBin++;
-        }
-      }
-
-      //
-      // We want to now make a vector of histograms that are 
-      //  projections across the cross section matrix, 
-      //  this means we want to have vectors where one histogram 
-      //  is made for each bin on variable X where the histogram
-      //  then contains bins for variable Y. 
-      //
-      //  This will allow us to do a 2D interpolation across the
-      //  full parameter space using cubic spline fits 
-      //
-
-      std::vector< TH1F > MomentumBins;
-      MomentumBins.resize(Ntbins);
-      for(int bin = 0; bin < Ntbins; bin++){
-        MomentumBins[bin] = TH1F("HARPp",";;;", Npbins, HARPmomentumBins);
-        MomentumBins[bin].SetBit(kCanDelete);
-      } 
-
-      //Setup vectors of splines for fitting
-      std::vector< TSpline3 > SplinesVsMomentum; 
-      SplinesVsMomentum.resize(Ntbins);
-
-      for(int tbin = 0; tbin < Ntbins; tbin++){
-        for(int pbin = 0; pbin < Npbins; pbin++){
-
-          //
-          // We want to create spline at fixed theta values, that way we can 
-          // study the cross section at the given meson momentum
-          MomentumBins[tbin].SetBinContent(pbin+1, smearedHARPXSec[0][pbin][tbin]);        
-          // This will give us the cross section in discreet slices of theta (tbin)
-          // but each histogram in the vector will be the cross section in bins of
-          // momentum that can then be cublic splined  
-          //
+          // The cross section at the meson's momentum in this theta bin
+          double XSecAtP = 0;
+          for(int pbin = 0; pbin < Npbins; pbin++){
+            XSecAtP += MomentumCoeff[pbin] * smearedHARPXSec[pbin*Ntbins + tbin];
+          }
+          // which used to be stored in the bins of a TH1F
+          RW += ThetaCoeff[tbin] * float(XSecAtP);
         }
 
         //
-        // in a given theta slice we can now spline over the cross section entries
-        // in bins of momentum
-        //
-        // Important note about Splines, MiniBooNE used constraints on the
-        // second derivative of the first and final knot point and required 
-        // that they both equal to zero, this is not naturally the case in 
-        // in TSpline3 but it is default in DCSPLC (the Fortran CERN library spline function)
-        // this helps to control the smoothness of the spline and minimizes the variation bin to bin
-        // For TSpine3 this is controlled by:
-        //
-        //  b1 = constrain first knot 1st derivative 
-        //  b2 = constrain first knot 2nd derivative 
-        //  e1 = constrain final knot 1st derivative 
-        //  e2 = constrain final knot 2nd derivative 
+        // These guards are inherited from MiniBooNE code
         //
-        //  the numbers that follow are the values you constrain those conditions to
+        // These were defined here: 
+        // 
+        //   cdcvs0.fnal.gov/cgi-bin/public-cvs/cvsweb-public.cgi/~checkout~/ ... 
+        //              miniboone/AnalysisFramework/MultisimMatrix/src/MultisimMatrix.inc    
         //
-        SplinesVsMomentum[tbin] = TSpline3(&(MomentumBins[tbin]),"b2e2",0,0); 
+        //  This forces any negative spline fit to be 1     
 
-      }
-      MomentumBins.clear();
-      delete smearedHARPXSec;
-      //
-      // Now that we have the 1D Splines over momentum we want to know
-      // what the cross section is for the meson's momentum in bins of
-      // theta that way we can extract the cross section at the meson's
-      // theta. 
-      //
-      TH1F* ThetaBins = new TH1F("HARPt",";;;", Ntbins, HARPthetaBins);
-      ThetaBins->SetBit(kCanDelete);
-      for(int tbin = 0; tbin < Ntbins; tbin++){
-        ThetaBins->SetBinContent(tbin+1, SplinesVsMomentum[tbin].Eval(HadronVec.P()));
-      } 
-
-      ////      
-      // Now we can spline across the theta bins and we can extract the exact value of the 
-      // cross section for the meson's theta value
-      //
-      //  Options described above.
-      /////
-
-      TSpline3* FinalSpline = new TSpline3(ThetaBins,"b2e2",0,0);
-
-      double RW = FinalSpline->Eval(ThetaOfInterest);
+        ////////
+        //  Possible Bug.
+        ////////     
+        // This seems to be a feature in the MiniBooNE code
+        //  It looks like the intension is to set this to zero
+        //  but it is set to 1 before it is set to zero  
 
-      SplinesVsMomentum.clear();
-      delete ThetaBins;
-      delete FinalSpline;
+        double weight = 1; 
 
-      //
-      // These guards are inherited from MiniBooNE code
-      //
-      // These were defined here: 
-      // 
-      //   cdcvs0.fnal.gov/cgi-bin/public-cvs/cvsweb-public.cgi/~checkout~/ ... 
-      //              miniboone/AnalysisFramework/MultisimMatrix/src/MultisimMatrix.inc    
-      //
-      //  This forces any negative spline fit to be 1     
-
-      ////////
-      //  Possible Bug.
-      ////////     
-      // This seems to be a feature in the MiniBooNE code
-      //  It looks like the intension is to set this to zero
-      //  but it is set to 1 before it is set to zero  
-
-      double weight = 1; 
-
-      if(RW < 0 || CV < 0){
-        weight = 1;
-      }
-      else if(fabs(CV) < 1.e-12){
-        weight = 1;
-      }
-      else{
-        weight *= RW/CV;
-      }
+        if(RW < 0 || CV < 0){
+          weight = 1;
+        }
+        else if(fabs(CV) < 1.e-12){
+          weight = 1;
+        }
+        else{
+          weight *= RW/CV;
+        }
 
-      if(weight < 0) weight = 0; 
-      if(weight > 30) weight = 30; 
-      if(!(std::isfinite(weight))){
-        std::cout << "SW+Splines : Failed to get a finite weight" << std::endl;   
-        weight = 30;
-      }
+        if(weight < 0) weight = 0; 
+        if(weight > 30) weight = 30; 
+        if(!(std::isfinite(weight))){
+          std::cout << "SW+Splines : Failed to get a finite weight" << std::endl;   
+          weight = 30;
+        }
 
-      std::pair<bool, double> output(parameters_pass, weight);
-      return output; 
+        weights[i] = weight;
+      }//Iterate through the number of universes
 
     }// Done with the WeigthCalc function
 
@@ -20,6 +20,7 @@
 // Standard library includes
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 
 // Framework includes
@@ -221,6 +222,59 @@ namespace {//Helper functions are defined in this block
   // then variation weights will be thrown around the tuned CV.
   std::set< std::string > CALC_NAMES_THAT_IGNORE_TUNED_CV = { "RootinoFix" };
 
+  // What the GENIE weight calculators need for one neutrino. Every
+  // calculator is given the same one through the WeightContext, so that the
+  // event record is rebuilt once per neutrino rather than once per calculator
+  struct GenieEventCache {
+    const simb::GTruth* gtruth = nullptr;
+    std::unique_ptr< genie::EventRecord > record;
+  };
+
+  std::unique_ptr< GenieEventCache > MakeGenieEventCache( art::Event& e,
+        const std::string& genie_module_label, size_t inu ) {
+    // Actually go and get the stuff
+    auto const& mclist = e.getProduct<std::vector<simb::MCTruth>>( genie_module_label );
+    auto const& glist = e.getProduct<std::vector<simb::GTruth>>( genie_module_label );
+
+    // Convert the MCTruth and GTruth objects from the event
+    // back into the original genie::EventRecord needed to
+    // compute the weights
+    auto cache = std::make_unique< GenieEventCache >();
+    cache->gtruth = &glist[inu];
+    cache->record.reset( evgb::RetrieveGHEP(mclist[inu], glist[inu]) );
+
+    // Set the final lepton kinetic energy and scattering cosine
+    // in the owned GENIE kinematics object. This is done during
+    // event generation but is not reproduced by evgb::RetrieveGHEP().
+    // Several new CCMEC weight calculators developed for MicroBooNE
+    // expect the variables to be set in this way (so that differential
+    // cross sections can be recomputed). Failing to set them results
+    // in inf and NaN weights.
+    // TODO: maybe update evgb::RetrieveGHEP to handle this instead.
+    genie::Interaction* interaction = cache->record->Summary();
+    genie::Kinematics* kine_ptr = interaction->KinePtr();
+
+    // Final lepton mass
+    double ml = interaction->FSPrimLepton()->Mass();
+    // Final lepton 4-momentum
+    const TLorentzVector& p4l = kine_ptr->FSLeptonP4();
+    // Final lepton kinetic energy
+    double Tl = p4l.E() - ml;
+    // Final lepton scattering cosine
+    double ctl = p4l.CosTheta();
+
+    kine_ptr->SetKV( kKVTl, Tl );
+    kine_ptr->SetKV( kKVctl, ctl );
+
+    return cache;
+  }
+
+  // The GENIE models are shared through its AlgFactory, and some keep
+  // state between calls (LwlynSmithQELCCPXSec's QELFormFactors, for one), as
+  // do its Messenger and configuration pool. The GENIE calculators therefore
+  // run one at a time, even when WeightManager runs calculators concurrently
+  std::mutex gGenieMutex;
+
 } // anonymous namespace
 
 
@@ -233,10 +287,14 @@ public:
   void Configure(fhicl::ParameterSet const& pset,
                  CLHEP::HepRandomEngine& engine) override;
 
-  std::vector<float> GetWeight(art::Event& e, size_t inu) override;
+  std::vector<float> GetWeight(WeightContext& ctx) override;
 
 private:
   std::vector< genie::rew::GReWeight > reweightVector;
+  std::vector< bool > fUsesMaCCQE; ///< Per universe: whether the MaCCQE knob is included
+
+  void CalcWeights(const genie::EventRecord& event, bool is_strange,
+        std::vector<float>& weights);
 
   std::string fGenieModuleLabel;
   std::string fTuneName;
@@ -481,80 +539,69 @@ void GenieWeightCalc::Configure(fhicl::ParameterSet const& p,
     rwght.Reconfigure();//Apply all set knobs, i.e. use the updated syst.
     rwght.Print();
   }//next universe
+
+  // The knobs do not change after this point: look for MaCCQE once, rather
+  // than for every universe of every event
+  fUsesMaCCQE.resize( reweightVector.size() );
+  for ( size_t univ = 0; univ < reweightVector.size(); ++univ ) {
+    std::vector< genie::rew::GSyst_t > ak = reweightVector[univ].Systematics().AllIncluded();//all konbs used
+    fUsesMaCCQE[univ] = std::find(ak.begin(), ak.end(), kXSecTwkDial_MaCCQE) != ak.end();
+  }
 }
 
 //Keng:
 //copied from larsim's GetWeight()
 //2d weights --> 1d weights; no major modifications.
-std::vector<float> GenieWeightCalc::GetWeight(art::Event& e, size_t inu) {
-    // Get the MC generator information out of the event
-    // These are both handles to MC information.
-    art::Handle< std::vector<simb::MCTruth> > mcTruthHandle;
-    art::Handle< std::vector<simb::GTruth> > gTruthHandle;
+std::vector<float> GenieWeightCalc::GetWeight(WeightContext& ctx) {
+    std::lock_guard< std::mutex > genie_lock( gGenieMutex );
 
-    // Actually go and get the stuff
-    auto const& mclist = e.getProduct<std::vector<simb::MCTruth>>( fGenieModuleLabel );
-    auto const& glist = e.getProduct<std::vector<simb::GTruth>>( fGenieModuleLabel );
+    // The record is built by the first GENIE calculator asking for it.
+    // Those with another generator label get their own.
+    GenieEventCache& cache = ctx.Get< GenieEventCache >(
+      "GenieEventCache:" + fGenieModuleLabel, [&]() {
+        return MakeGenieEventCache( ctx.Event(), fGenieModuleLabel, ctx.Index() );
+      } );
+    genie::EventRecord* genie_event = cache.record.get();
 
     size_t num_knobs = reweightVector.size();
 
     // Calculate weight(s) here
     std::vector< float > weights( num_knobs );
-//    std::vector< std::vector<double> > weights( num_neutrinos );
-
-      // Convert the MCTruth and GTruth objects from the event
-      // back into the original genie::EventRecord needed to
-      // compute the weights
-      std::unique_ptr< genie::EventRecord >
-        genie_event( evgb::RetrieveGHEP(mclist[inu], glist[inu]) );
-
-      // Set the final lepton kinetic energy and scattering cosine
-      // in the owned GENIE kinematics object. This is done during
-      // event generation but is not reproduced by evgb::RetrieveGHEP().
-      // Several new CCMEC weight calculators developed for MicroBooNE
-      // expect the variables to be set in this way (so that differential
-      // cross sections can be recomputed). Failing to set them results
-      // in inf and NaN weights.
-      // TODO: maybe update evgb::RetrieveGHEP to handle this instead.
-      genie::Interaction* interaction = genie_event->Summary();
-      genie::Kinematics* kine_ptr = interaction->KinePtr();
-
-      // Final lepton mass
-      double ml = interaction->FSPrimLepton()->Mass();
-      // Final lepton 4-momentum
-      const TLorentzVector& p4l = kine_ptr->FSLeptonP4();
-      // Final lepton kinetic energy
-      double Tl = p4l.E() - ml;
-      // Final lepton scattering cosine
-      double ctl = p4l.CosTheta();
-
-      kine_ptr->SetKV( kKVTl, Tl );
-      kine_ptr->SetKV( kKVctl, ctl );
-
-      // All right, the event record is fully ready. Now ask the GReWeight
-      // objects to compute the weights.
-
-    for (size_t k = 0u; k < num_knobs; ++k ) {//one "knob" for one universe;
-      //Add exception to avoid "FATAL KineLimits", 
-      //  see https://github.com/GENIE-MC/Reweight/issues/12
-      std::vector< genie::rew::GSyst_t > ak = reweightVector.at( k ).Systematics().AllIncluded();//all konbs used
-
-      //NOTE: this line is to skip reweighting stange-CCQE events 
-      //Among 7500 events, 207 of them are strange events; ~3%
-      if(glist[inu].fIsStrange && std::find(ak.begin(), ak.end(),  kXSecTwkDial_MaCCQE) != ak.end()){
-        weights[k] = 1;
-      } else{
-        weights[k] = reweightVector.at( k ).CalcWeight( *genie_event );
-        reweightVector.at(k).Print();
-      }
-//  std::cout<<"CHECK "<<k<<" universe weight "<<weights[k]<<std::endl;
+
+    // All right, the event record is fully ready. Now ask the GReWeight
+    // objects to compute the weights.
+
+    // The universes are computed one after the other: all the GReWeight
+    // objects share the GENIE models of its AlgFactory (some of which keep
+    // state between calls), its Messenger and its configuration pool, none
+    // of which is thread safe
+    CalcWeights( *genie_event, cache.gtruth->fIsStrange, weights );
+
+    if ( !fQuietMode ) {
+      for ( auto& rwght : reweightVector ) rwght.Print();
     }
-//  std::cout<<"Finish Event # "<<e.event()<<std::endl;
 
     return weights;
 }
 
 
+void GenieWeightCalc::CalcWeights(const genie::EventRecord& event,
+    bool is_strange, std::vector<float>& weights) {
+  for (size_t k = 0u; k < weights.size(); ++k ) {//one "knob" for one universe;
+    //Add exception to avoid "FATAL KineLimits",
+    //  see https://github.com/GENIE-MC/Reweight/issues/12
+
+    //NOTE: this line is to skip reweighting stange-CCQE events
+    //Among 7500 events, 207 of them are strange events; ~3%
+    if( is_strange && fUsesMaCCQE[k] ){
+      weights[k] = 1;
+    } else{
+      weights[k] = reweightVector[k].CalcWeight( event );
+    }
+  }
+}
+
+
 std::map< std::string, int > GenieWeightCalc::CheckForIncompatibleSystematics(
     const std::vector<genie::rew::GSyst_t>& knob_vec){
     std::map< std::string, int > modes_to_use;